@@ -7,7 +7,7 @@ DESTDIR = build
 INCLUDEPATH += .
 MOC_DIR = build
 OBJECTS_DIR = build
-QT += webkitwidgets widgets
+QT += concurrent webkitwidgets widgets
 TARGET = navim
 TEMPLATE = app
 
@@ -15,5 +15,5 @@ QMAKE_CXXFLAGS_DEBUG += -pedantic -Wall -Wextra -Wold-style-cast -Woverloaded-vi
 QMAKE_CXXFLAGS_RELEASE += -O2 -Os -s
 
 # Input
-HEADERS += src/Window.hpp src/ModalWebView.hpp
-SOURCES += src/main.cpp src/Window.cpp src/ModalWebView.cpp
+HEADERS += src/Window.hpp src/ModalWebView.hpp src/NetworkAccessManager.hpp src/SiteProfiles.hpp src/WebPage.hpp src/Download.hpp src/DownloadManager.hpp src/TextViewer.hpp src/HeadlessRenderer.hpp src/Throttler.hpp src/HintGenerator.hpp src/Frecency.hpp src/IndexSegment.hpp src/IndexSegmentWriter.hpp src/PageIndex.hpp src/FrameTimer.hpp src/TiledWebView.hpp src/StartupTrace.hpp src/Session.hpp src/Prerenderer.hpp src/IdleScheduler.hpp src/Archive.hpp src/ArchiveWriter.hpp src/ArchiveReply.hpp src/KeyRecorder.hpp src/KeyReplayer.hpp src/ResourceMonitor.hpp src/ArticleExtractor.hpp src/DownscaledImageReply.hpp src/CookieJar.hpp src/BrowserContext.hpp
+SOURCES += src/main.cpp src/Window.cpp src/ModalWebView.cpp src/NetworkAccessManager.cpp src/SiteProfiles.cpp src/WebPage.cpp src/Download.cpp src/DownloadManager.cpp src/TextViewer.cpp src/HeadlessRenderer.cpp src/Throttler.cpp src/HintGenerator.cpp src/Frecency.cpp src/IndexSegment.cpp src/IndexSegmentWriter.cpp src/PageIndex.cpp src/FrameTimer.cpp src/TiledWebView.cpp src/StartupTrace.cpp src/Session.cpp src/Prerenderer.cpp src/IdleScheduler.cpp src/Archive.cpp src/ArchiveWriter.cpp src/ArchiveReply.cpp src/KeyRecorder.cpp src/KeyReplayer.cpp src/ResourceMonitor.cpp src/ArticleExtractor.cpp src/DownscaledImageReply.cpp src/CookieJar.cpp src/BrowserContext.cpp
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <QtEndian>
+
+#include "Archive.hpp"
+
+char const Archive::MAGIC[] = "NVAR0001";
+QString const Archive::SUFFIX = ".narc";
+
+Archive::Archive(QString const& path) : file(path), main(), resources() {
+    if(not file.open(QIODevice::ReadOnly) or file.size() < HEADER_SIZE) {
+        return;
+    }
+
+    size = file.size();
+    data = file.map(0, size);
+    if(nullptr == data or 0 != std::memcmp(data, MAGIC, 8)) {
+        data = nullptr;
+        return;
+    }
+
+    //The offsets and the lengths are compared to what remains of the file, so that a corrupted value cannot overflow.
+    quint64 const fileSize{quint64(size)};
+    quint32 count{qFromLittleEndian<quint32>(data + 8)};
+    quint64 position{qFromLittleEndian<quint64>(data + 16)};
+    for(quint32 i{0} ; i < count ; i++) {
+        if(position > fileSize or INDEX_ENTRY_SIZE > fileSize - position) {
+            data = nullptr;
+            return;
+        }
+        Resource resource{QByteArray(), qFromLittleEndian<quint64>(data + position + 8), qFromLittleEndian<quint64>(data + position)};
+        quint32 urlLength{qFromLittleEndian<quint32>(data + position + 16)};
+        quint32 contentTypeLength{qFromLittleEndian<quint32>(data + position + 20)};
+        position += INDEX_ENTRY_SIZE;
+        if(quint64(urlLength) + contentTypeLength > fileSize - position or resource.offset > fileSize or resource.length > fileSize - resource.offset) {
+            data = nullptr;
+            return;
+        }
+
+        QString url{QString::fromUtf8(reinterpret_cast<char const*>(data + position), int(urlLength))};
+        resource.contentType = QByteArray(reinterpret_cast<char const*>(data + position + urlLength), int(contentTypeLength));
+        position += urlLength + contentTypeLength;
+        if(0 == i) {
+            main = QUrl(url);
+        }
+        resources[url] = resource;
+    }
+}
+
+bool Archive::contains(QUrl const& url) const {
+    return nullptr != data and resources.contains(key(url));
+}
+
+bool Archive::isValid() const {
+    return nullptr != data;
+}
+
+QString Archive::key(QUrl const& url) {
+    return url.toString(QUrl::RemoveFragment);
+}
+
+QUrl Archive::mainURL() const {
+    return main;
+}
+
+QByteArray Archive::read(QUrl const& url, QByteArray& contentType) const {
+    auto it(resources.find(key(url)));
+    if(nullptr == data or it == resources.end()) {
+        return QByteArray();
+    }
+    contentType = it->contentType;
+    return qUncompress(data + it->offset, int(it->length));
+}
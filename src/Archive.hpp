@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARCHIVE_HPP
+#define ARCHIVE_HPP
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QUrl>
+
+/*
+ * Offline snapshot of a page, memory-mapped to serve its resources without network.
+ * Layout (little endian):
+ *     header: "NVAR0001", resource count (32 bits), padding (32 bits), index offset (64 bits)
+ *     resources compressed with qCompress
+ *     index: data offset (64 bits), compressed length (64 bits), URL length (32 bits), content type length
+ *     (32 bits), URL, content type, for every resource
+ * The first resource is the main document.
+ */
+class Archive {
+    public:
+        static int const HEADER_SIZE = 24;
+        static int const INDEX_ENTRY_SIZE = 24;
+        static char const MAGIC[];
+        static QString const SUFFIX;
+
+        Archive(QString const& path);
+
+        Archive(Archive const&) = delete;
+
+        Archive& operator=(Archive const&) = delete;
+
+        /*
+         * Check if the resource is in the archive.
+         */
+        bool contains(QUrl const& url) const;
+
+        /*
+         * Check if the archive was opened.
+         */
+        bool isValid() const;
+
+        /*
+         * Get the key of the resource in the index.
+         */
+        static QString key(QUrl const& url);
+
+        /*
+         * Get the URL of the main document.
+         */
+        QUrl mainURL() const;
+
+        /*
+         * Uncompress the resource and get its content type.
+         */
+        QByteArray read(QUrl const& url, QByteArray& contentType) const;
+
+    private:
+        struct Resource {
+            QByteArray contentType;
+            quint64 length;
+            quint64 offset;
+        };
+
+        uchar const* data = nullptr;
+        QFile file;
+        QUrl main;
+        QHash<QString, Resource> resources;
+        qint64 size = 0;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <QTimer>
+
+#include "ArchiveReply.hpp"
+
+ArchiveReply::ArchiveReply(QNetworkRequest const& request, QByteArray const& contentType, QByteArray const& initialContent, QObject* parent) : QNetworkReply(parent), content(initialContent) {
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(QNetworkAccessManager::GetOperation);
+    setHeader(QNetworkRequest::ContentTypeHeader, contentType);
+    setHeader(QNetworkRequest::ContentLengthHeader, content.size());
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    setFinished(true);
+
+    //The signals are emitted once the caller is connected to them.
+    QTimer::singleShot(0, this, [this]() {
+        emit metaDataChanged();
+        emit readyRead();
+        emit finished();
+    });
+}
+
+void ArchiveReply::abort() {
+}
+
+qint64 ArchiveReply::bytesAvailable() const {
+    return content.size() - position + QNetworkReply::bytesAvailable();
+}
+
+bool ArchiveReply::isSequential() const {
+    return true;
+}
+
+qint64 ArchiveReply::readData(char* data, qint64 maxSize) {
+    qint64 length{std::min(maxSize, content.size() - position)};
+    if(length <= 0) {
+        return -1;
+    }
+    std::memcpy(data, content.constData() + position, size_t(length));
+    position += length;
+    return length;
+}
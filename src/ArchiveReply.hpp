@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARCHIVEREPLY_HPP
+#define ARCHIVEREPLY_HPP
+
+#include <QNetworkReply>
+
+/*
+ * Reply serving a resource read from an archive.
+ */
+class ArchiveReply : public QNetworkReply {
+    public:
+        ArchiveReply(QNetworkRequest const& request, QByteArray const& contentType, QByteArray const& initialContent, QObject* parent = nullptr);
+
+        ArchiveReply(ArchiveReply const&) = delete;
+
+        ArchiveReply& operator=(ArchiveReply const&) = delete;
+
+        virtual void abort();
+
+        virtual qint64 bytesAvailable() const;
+
+        virtual bool isSequential() const;
+
+    protected:
+        virtual qint64 readData(char* data, qint64 maxSize);
+
+    private:
+        QByteArray content;
+        qint64 position = 0;
+};
+
+#endif
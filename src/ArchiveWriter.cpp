@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QtEndian>
+
+#include "ArchiveWriter.hpp"
+
+ArchiveWriter::ArchiveWriter(QString const& path) : file(path), index() {
+    if(file.open(QIODevice::WriteOnly)) {
+        file.write(QByteArray(Archive::HEADER_SIZE, '\0'));
+    }
+}
+
+void ArchiveWriter::add(QUrl const& url, QByteArray const& contentType, QByteArray const& data) {
+    QByteArray compressed{qCompress(data)};
+    QByteArray key{Archive::key(url).toUtf8()};
+
+    uchar entry[Archive::INDEX_ENTRY_SIZE];
+    qToLittleEndian<quint64>(position, entry);
+    qToLittleEndian<quint64>(quint64(compressed.size()), entry + 8);
+    qToLittleEndian<quint32>(quint32(key.size()), entry + 16);
+    qToLittleEndian<quint32>(quint32(contentType.size()), entry + 20);
+    index.append(reinterpret_cast<char const*>(entry), Archive::INDEX_ENTRY_SIZE);
+    index.append(key);
+    index.append(contentType);
+
+    file.write(compressed);
+    position += quint64(compressed.size());
+    resourceCount++;
+}
+
+bool ArchiveWriter::commit() {
+    file.write(index);
+
+    uchar header[Archive::HEADER_SIZE]{};
+    std::copy(Archive::MAGIC, Archive::MAGIC + 8, header);
+    qToLittleEndian<quint32>(resourceCount, header + 8);
+    qToLittleEndian<quint64>(position, header + 16);
+    file.seek(0);
+    file.write(reinterpret_cast<char const*>(header), Archive::HEADER_SIZE);
+    return file.commit();
+}
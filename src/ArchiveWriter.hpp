@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARCHIVEWRITER_HPP
+#define ARCHIVEWRITER_HPP
+
+#include <QSaveFile>
+
+#include "Archive.hpp"
+
+/*
+ * Writer streaming the compressed resources of a new archive to disk.
+ * The file only appears when committed.
+ */
+class ArchiveWriter {
+    public:
+        ArchiveWriter(QString const& path);
+
+        ArchiveWriter(ArchiveWriter const&) = delete;
+
+        ArchiveWriter& operator=(ArchiveWriter const&) = delete;
+
+        /*
+         * Compress and write a resource (the first one is the main document).
+         */
+        void add(QUrl const& url, QByteArray const& contentType, QByteArray const& data);
+
+        /*
+         * Write the index and the header, and move the file in place.
+         */
+        bool commit();
+
+    private:
+        QSaveFile file;
+        QByteArray index;
+        quint64 position = Archive::HEADER_SIZE;
+        quint32 resourceCount = 0;
+};
+
+#endif
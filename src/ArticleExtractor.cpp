@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QRegularExpression>
+#include <QVector>
+#include <QWebElementCollection>
+
+#include "ArticleExtractor.hpp"
+
+static QString const CANDIDATE_ATTRIBUTE{"data-navim-candidate"};
+
+static QString const STYLESHEET{
+    "body { margin: 2em auto; max-width: 40em; padding: 0 1em; font: 1.15em/1.6 serif; color: #222; background: #fafafa; }"
+    "img, video { max-width: 100%; height: auto; }"
+    "pre { overflow: auto; }"
+};
+
+double ArticleExtractor::classWeight(QWebElement const& element) {
+    static QRegularExpression const POSITIVE{"article|body|content|entry|main|page|post|story|text", QRegularExpression::CaseInsensitiveOption};
+    static QRegularExpression const NEGATIVE{"banner|comment|footer|header|menu|nav|related|share|sidebar|social|sponsor|widget", QRegularExpression::CaseInsensitiveOption};
+
+    double weight{0};
+    QString tag{element.tagName().toLower()};
+    if("article" == tag or "main" == tag) {
+        weight += 25;
+    }
+    QString names{element.attribute("class") + " " + element.attribute("id")};
+    if(POSITIVE.match(names).hasMatch()) {
+        weight += 25;
+    }
+    if(NEGATIVE.match(names).hasMatch()) {
+        weight -= 25;
+    }
+    return weight;
+}
+
+QString ArticleExtractor::extract(QWebFrame* frame) {
+    QVector<QWebElement> candidates;
+    QVector<double> scores;
+    //The index of a candidate is kept in an attribute of the element, to find it without a scan of the candidates.
+    auto addScore = [&candidates, &scores](QWebElement element, double score) {
+        if(element.isNull()) {
+            return;
+        }
+        bool known{false};
+        int index{element.attribute(CANDIDATE_ATTRIBUTE).toInt(&known)};
+        if(not known) {
+            element.setAttribute(CANDIDATE_ATTRIBUTE, QString::number(candidates.size()));
+            candidates.append(element);
+            scores.append(classWeight(element));
+            index = candidates.size() - 1;
+        }
+        scores[index] += score;
+    };
+
+    for(QWebElement const& paragraph : frame->findAllElements("p, pre, td")) {
+        QString text{paragraph.toPlainText().simplified()};
+        if(text.size() < MINIMUM_PARAGRAPH_LENGTH) {
+            continue;
+        }
+        //Long paragraphs with many clauses are more likely to be content.
+        double score{1.0 + text.count(',') + std::min(text.size() / 100, 3)};
+        addScore(paragraph.parent(), score);
+        addScore(paragraph.parent().parent(), score / 2);
+    }
+
+    for(QWebElement candidate : candidates) {
+        candidate.removeAttribute(CANDIDATE_ATTRIBUTE);
+    }
+
+    int best{-1};
+    double bestScore{0};
+    for(int i{0} ; i < candidates.size() ; i++) {
+        double score{scores[i] * (1 - linkDensity(candidates[i]))};
+        if(score > bestScore) {
+            best = i;
+            bestScore = score;
+        }
+    }
+    if(-1 == best) {
+        return QString();
+    }
+
+    //The article is copied, so that the page is not modified, and cleaned from what needs scripts or distracts.
+    QWebElement article{candidates[best].clone()};
+    for(QWebElement element : article.findAll("script, style, link, noscript, iframe, object, embed, form, button, input, select, textarea, nav, aside, footer")) {
+        element.removeFromDocument();
+    }
+    for(QWebElement element : article.findAll("*")) {
+        element.removeAttribute("style");
+    }
+
+    QString title{frame->title().toHtmlEscaped()};
+    return QString("<!DOCTYPE html><html><head><meta charset=\"utf-8\"><title>%1</title><style>%2</style></head><body><h1>%1</h1>%3</body></html>").arg(title, STYLESHEET, article.toInnerXml());
+}
+
+double ArticleExtractor::linkDensity(QWebElement const& element) {
+    int length{element.toPlainText().simplified().size()};
+    if(0 == length) {
+        return 1;
+    }
+    int linkLength{0};
+    for(QWebElement const& link : element.findAll("a")) {
+        linkLength += link.toPlainText().simplified().size();
+    }
+    return std::min(1.0, double(linkLength) / length);
+}
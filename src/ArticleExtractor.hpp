@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ARTICLEEXTRACTOR_HPP
+#define ARTICLEEXTRACTOR_HPP
+
+#include <QString>
+#include <QWebElement>
+#include <QWebFrame>
+
+/*
+ * Extractor of the main content of a page for the reader mode.
+ * The paragraphs give a score to their parent and half of it to their grandparent: the element with the best score,
+ * weighted by its class and its link density, is the article.
+ */
+class ArticleExtractor {
+    public:
+        /*
+         * Get a standalone document, without scripts, showing the article of the frame (empty if none is found).
+         */
+        static QString extract(QWebFrame* frame);
+
+    private:
+        static int const MINIMUM_PARAGRAPH_LENGTH = 25;
+
+        /*
+         * Get the weight given to the element by its tag, class and id.
+         */
+        static double classWeight(QWebElement const& element);
+
+        /*
+         * Get the ratio of the text of the element which is in links.
+         */
+        static double linkDensity(QWebElement const& element);
+};
+
+#endif
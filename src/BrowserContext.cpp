@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include "BrowserContext.hpp"
+
+BrowserContext::BrowserContext(QString const& initialConfigPath, SiteProfiles const& initialSiteProfiles) : cacheLock(), configPath(initialConfigPath), siteProfiles(initialSiteProfiles) {
+}
+
+CookieJar* BrowserContext::cookieJar() const {
+    return jar;
+}
+
+NetworkAccessManager* BrowserContext::createNetworkAccessManager(bool sessionCookiesKept, QObject* parent) {
+    networkAccessManager = new NetworkAccessManager(siteProfiles, parent);
+
+    //The cookies are read before the first request, which may need a login cookie.
+    jar = new CookieJar(configPath + "/cookies", sessionCookiesKept);
+    networkAccessManager->setCookieJar(jar);
+
+    //QNetworkDiskCache cannot be shared by processes: every process has its own directory, locked while it runs.
+    QString cacheDirectory{configPath + "/cache/" + QString::number(QCoreApplication::applicationPid())};
+    QDir().mkpath(cacheDirectory);
+    cacheLock.reset(new QLockFile(cacheDirectory + ".lock"));
+    cacheLock->setStaleLockTime(0);
+    cacheLock->tryLock(0);
+    networkCache = new QNetworkDiskCache(networkAccessManager);
+    networkCache->setCacheDirectory(cacheDirectory);
+    networkCache->setMaximumCacheSize(cacheSize * 1024 * 1024);
+    networkAccessManager->setCache(networkCache);
+
+    networkAccessManager->setHttp2Enabled(http2Enabled);
+    networkAccessManager->setPipeliningEnabled(pipeliningEnabled);
+    QScreen* screen{QGuiApplication::primaryScreen()};
+    if(imageDownscaling and nullptr != screen) {
+        //There is no zoom: an image is never shown larger than the screen.
+        networkAccessManager->setMaximumImageSize(screen->size() * screen->devicePixelRatio());
+    }
+    return networkAccessManager;
+}
+
+WebPage* BrowserContext::createPage(QObject* parent) const {
+    WebPage* page{new WebPage(siteProfiles, networkAccessManager, parent)};
+    page->setScriptBudget(scriptBudget);
+    return page;
+}
+
+QString BrowserContext::defaultConfigPath() {
+    return QDir::homePath() + "/.navim";
+}
+
+QNetworkDiskCache* BrowserContext::diskCache() const {
+    return networkCache;
+}
+
+void BrowserContext::loadConfig(QSettings const& config) {
+    cacheSize = config.value("cache/size", cacheSize).toLongLong();
+    http2Enabled = config.value("network/http2", http2Enabled).toBool();
+    imageDownscaling = config.value("images/downscale", imageDownscaling).toBool();
+    pipeliningEnabled = config.value("network/pipelining", pipeliningEnabled).toBool();
+    scriptBudget = config.value("javascript/budget", scriptBudget).toLongLong();
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BROWSERCONTEXT_HPP
+#define BROWSERCONTEXT_HPP
+
+#include <memory>
+
+#include <QLockFile>
+#include <QNetworkDiskCache>
+#include <QObject>
+#include <QSettings>
+#include <QString>
+
+#include "CookieJar.hpp"
+#include "NetworkAccessManager.hpp"
+#include "SiteProfiles.hpp"
+#include "WebPage.hpp"
+
+/*
+ * Network and page setup shared by the windows and the headless renderer, so that they load the pages the same way:
+ * the cookie jar, the disk cache, the protocols, the image downscaling and the script budget.
+ */
+class BrowserContext {
+    public:
+        BrowserContext(QString const& initialConfigPath, SiteProfiles const& initialSiteProfiles);
+
+        BrowserContext(BrowserContext const&) = delete;
+
+        BrowserContext& operator=(BrowserContext const&) = delete;
+
+        /*
+         * Get the cookie jar (null before the network access manager is created).
+         */
+        CookieJar* cookieJar() const;
+
+        /*
+         * Create the network access manager with its cookie jar and its disk cache.
+         */
+        NetworkAccessManager* createNetworkAccessManager(bool sessionCookiesKept, QObject* parent);
+
+        /*
+         * Create a page loading through the network access manager.
+         */
+        WebPage* createPage(QObject* parent = nullptr) const;
+
+        /*
+         * Get the path of the configuration directory used when none is specified.
+         */
+        static QString defaultConfigPath();
+
+        /*
+         * Get the disk cache (null before the network access manager is created).
+         */
+        QNetworkDiskCache* diskCache() const;
+
+        /*
+         * Read the network and page settings.
+         */
+        void loadConfig(QSettings const& config);
+
+    private:
+        std::unique_ptr<QLockFile> cacheLock;
+        qint64 cacheSize = 50;
+        QString configPath;
+        bool http2Enabled = true;
+        bool imageDownscaling = true;
+        CookieJar* jar = nullptr;
+        NetworkAccessManager* networkAccessManager = nullptr;
+        QNetworkDiskCache* networkCache = nullptr;
+        bool pipeliningEnabled = false;
+        qint64 scriptBudget = 5000;
+        SiteProfiles const& siteProfiles;
+};
+
+#endif
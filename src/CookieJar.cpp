@@ -0,0 +1,245 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QDateTime>
+#include <QFile>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QUrl>
+
+#include "CookieJar.hpp"
+
+CookieJar::CookieJar(QString const& filePath, bool sessionCookiesKept, QObject* parent) : QNetworkCookieJar(parent), deletedCookies(), domains(), modifiedCookies(), path(filePath) {
+    QList<QNetworkCookie> cookies{read(path)};
+    if(not sessionCookiesKept) {
+        //The browser session ended with the last window: its session cookies are removed from the file too.
+        for(auto it(cookies.begin()) ; it != cookies.end() ;) {
+            if(it->isSessionCookie()) {
+                deletedCookies.insert(key(*it));
+                it = cookies.erase(it);
+            }
+            else {
+                it++;
+            }
+        }
+    }
+    setCookies(cookies);
+}
+
+QList<QNetworkCookie> CookieJar::cookiesForUrl(QUrl const& url) const {
+    QString host{url.host().toLower()};
+    QString urlPath{url.path().isEmpty() ? "/" : url.path()};
+    bool secure{"https" == url.scheme() or "wss" == url.scheme()};
+    QDateTime now{QDateTime::currentDateTimeUtc()};
+
+    //Only the cookies of the host and of its parent domains are looked at.
+    QList<QNetworkCookie> result;
+    QString domain{host};
+    while(not domain.isEmpty()) {
+        QStringList keys{"." + domain};
+        if(domain == host) {
+            keys.append(domain);
+        }
+        for(QString const& domainKey : keys) {
+            for(QNetworkCookie const& cookie : domains.value(domainKey)) {
+                bool pathMatches{urlPath.startsWith(cookie.path()) and (urlPath.size() == cookie.path().size() or cookie.path().endsWith('/') or '/' == urlPath.at(cookie.path().size()))};
+                bool expired{not cookie.isSessionCookie() and cookie.expirationDate() < now};
+                if(pathMatches and not expired and (secure or not cookie.isSecure())) {
+                    result.append(cookie);
+                }
+            }
+        }
+        int index{domain.indexOf('.')};
+        if(-1 == index) {
+            break;
+        }
+        domain.remove(0, index + 1);
+    }
+
+    //The cookies with the most specific path are sent first.
+    std::stable_sort(result.begin(), result.end(), [](QNetworkCookie const& cookie1, QNetworkCookie const& cookie2) {
+        return cookie1.path().size() > cookie2.path().size();
+    });
+    return result;
+}
+
+bool CookieJar::deleteCookie(QNetworkCookie const& cookie) {
+    if(not QNetworkCookieJar::deleteCookie(cookie)) {
+        return false;
+    }
+    removeFromIndex(cookie);
+    modifiedCookies.remove(key(cookie));
+    deletedCookies.insert(key(cookie));
+    return true;
+}
+
+std::function<void()> CookieJar::flushTask() {
+    if(flushing or (modifiedCookies.isEmpty() and deletedCookies.isEmpty())) {
+        return nullptr;
+    }
+
+    //The changes are copied: they are only forgotten once written, so that save() writes them if the task never runs.
+    flushing = true;
+    QHash<QString, QNetworkCookie> modified{modifiedCookies};
+    QSet<QString> deleted{deletedCookies};
+    QString filePath{path};
+    CookieJar* jar{this};
+    return [jar, filePath, modified, deleted]() {
+        QList<QNetworkCookie> cookies;
+        bool saved{write(filePath, modified, deleted, cookies)};
+        QMetaObject::invokeMethod(jar, [jar, saved, cookies, modified, deleted]() {
+            jar->flushing = false;
+            if(saved) {
+                jar->written(modified, deleted, cookies);
+            }
+        }, Qt::QueuedConnection);
+    };
+}
+
+bool CookieJar::insertCookie(QNetworkCookie const& cookie) {
+    //QNetworkCookieJar::insertCookie() deletes the cookie with the same key, expired cookies are only deleted.
+    if(not QNetworkCookieJar::insertCookie(cookie)) {
+        return false;
+    }
+    removeFromIndex(cookie);
+    domains[cookie.domain()].append(cookie);
+    deletedCookies.remove(key(cookie));
+    modifiedCookies.insert(key(cookie), cookie);
+    return true;
+}
+
+QString CookieJar::key(QNetworkCookie const& cookie) {
+    return cookie.domain() + ";" + cookie.path() + ";" + QString::fromUtf8(cookie.name());
+}
+
+QList<QNetworkCookie> CookieJar::read(QString const& filePath) {
+    QList<QNetworkCookie> cookies;
+    QFile file{filePath};
+    if(not file.open(QIODevice::ReadOnly)) {
+        return cookies;
+    }
+
+    QDateTime now{QDateTime::currentDateTimeUtc()};
+    for(QByteArray const& line : file.readAll().split('\n')) {
+        for(QNetworkCookie const& cookie : QNetworkCookie::parseCookies(line)) {
+            if(cookie.isSessionCookie() or cookie.expirationDate() >= now) {
+                cookies.append(cookie);
+            }
+        }
+    }
+    return cookies;
+}
+
+void CookieJar::removeFromIndex(QNetworkCookie const& cookie) {
+    auto it(domains.find(cookie.domain()));
+    if(it == domains.end()) {
+        return;
+    }
+    for(int i{0} ; i < it->size() ; i++) {
+        if(cookie.hasSameIdentifier(it->at(i))) {
+            it->removeAt(i);
+            break;
+        }
+    }
+    if(it->isEmpty()) {
+        domains.erase(it);
+    }
+}
+
+void CookieJar::save() {
+    if(modifiedCookies.isEmpty() and deletedCookies.isEmpty()) {
+        return;
+    }
+    QList<QNetworkCookie> cookies;
+    if(write(path, modifiedCookies, deletedCookies, cookies)) {
+        modifiedCookies.clear();
+        deletedCookies.clear();
+        setCookies(cookies);
+    }
+}
+
+void CookieJar::setCookies(QList<QNetworkCookie> const& cookies) {
+    setAllCookies(cookies);
+    domains.clear();
+    for(QNetworkCookie const& cookie : cookies) {
+        domains[cookie.domain()].append(cookie);
+    }
+}
+
+bool CookieJar::write(QString const& filePath, QHash<QString, QNetworkCookie> const& modified, QSet<QString> const& deleted, QList<QNetworkCookie>& cookies) {
+    //The lock prevents another process from writing its changes between the read and the write of this one.
+    QLockFile lock{filePath + ".lock"};
+    if(not lock.lock()) {
+        qWarning("Cannot lock %s", qPrintable(filePath));
+        return false;
+    }
+
+    QHash<QString, QNetworkCookie> merged;
+    for(QNetworkCookie const& cookie : read(filePath)) {
+        merged.insert(key(cookie), cookie);
+    }
+    for(QString const& cookieKey : deleted) {
+        merged.remove(cookieKey);
+    }
+    for(auto it(modified.begin()) ; it != modified.end() ; it++) {
+        merged.insert(it.key(), it.value());
+    }
+
+    QSaveFile file{filePath};
+    if(not file.open(QIODevice::WriteOnly)) {
+        qWarning("Cannot write the cookies to %s", qPrintable(filePath));
+        return false;
+    }
+    for(QNetworkCookie const& cookie : merged) {
+        file.write(cookie.toRawForm(QNetworkCookie::Full) + '\n');
+    }
+    //The cookies hold the logins of the user.
+    file.setPermissions(QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+    if(not file.commit()) {
+        qWarning("Cannot write the cookies to %s", qPrintable(filePath));
+        return false;
+    }
+    cookies = merged.values();
+    return true;
+}
+
+void CookieJar::written(QHash<QString, QNetworkCookie> const& modified, QSet<QString> const& deleted, QList<QNetworkCookie> const& cookies) {
+    for(auto it(modified.begin()) ; it != modified.end() ; it++) {
+        auto current(modifiedCookies.find(it.key()));
+        if(current != modifiedCookies.end() and current.value() == it.value()) {
+            modifiedCookies.erase(current);
+        }
+    }
+    for(QString const& cookieKey : deleted) {
+        deletedCookies.remove(cookieKey);
+    }
+
+    //The changes made while the file was written are kept for the next flush.
+    QHash<QString, QNetworkCookie> merged;
+    for(QNetworkCookie const& cookie : cookies) {
+        merged.insert(key(cookie), cookie);
+    }
+    for(QString const& cookieKey : deletedCookies) {
+        merged.remove(cookieKey);
+    }
+    for(auto it(modifiedCookies.begin()) ; it != modifiedCookies.end() ; it++) {
+        merged.insert(it.key(), it.value());
+    }
+    setCookies(merged.values());
+}
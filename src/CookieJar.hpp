@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COOKIEJAR_HPP
+#define COOKIEJAR_HPP
+
+#include <functional>
+
+#include <QHash>
+#include <QNetworkCookie>
+#include <QNetworkCookieJar>
+#include <QSet>
+
+/*
+ * Cookie jar shared by the window processes through a file, one cookie per line in its Set-Cookie form.
+ * The requests only use the memory: the changes are written later by a task merging them with the changes of the
+ * other processes under a lock. The changes stay in memory until they are written.
+ * The session cookies are also written, so that the running windows share the logins, but the first window of the next
+ * session drops them.
+ */
+class CookieJar : public QNetworkCookieJar {
+    public:
+        CookieJar(QString const& filePath, bool sessionCookiesKept, QObject* parent = nullptr);
+
+        CookieJar(CookieJar const&) = delete;
+
+        CookieJar& operator=(CookieJar const&) = delete;
+
+        virtual QList<QNetworkCookie> cookiesForUrl(QUrl const& url) const;
+
+        virtual bool deleteCookie(QNetworkCookie const& cookie);
+
+        /*
+         * Get the task writing the changes made since the last flush (an empty function if there is none).
+         * The task can run in another thread: the cookies of the other processes are then loaded in this thread.
+         */
+        std::function<void()> flushTask();
+
+        virtual bool insertCookie(QNetworkCookie const& cookie);
+
+        /*
+         * Write the changes made since the last flush.
+         */
+        void save();
+
+    private:
+        QSet<QString> deletedCookies;
+        QHash<QString, QList<QNetworkCookie>> domains;
+        bool flushing = false;
+        QHash<QString, QNetworkCookie> modifiedCookies;
+        QString path;
+
+        /*
+         * Get the key identifying the cookie: its name, domain and path.
+         */
+        static QString key(QNetworkCookie const& cookie);
+
+
+        /*
+         * Read the cookies which are not expired from the file.
+         */
+        static QList<QNetworkCookie> read(QString const& filePath);
+
+        /*
+         * Remove the cookie from the domain index.
+         */
+        void removeFromIndex(QNetworkCookie const& cookie);
+
+
+        /*
+         * Set the cookies and rebuild the domain index.
+         */
+        void setCookies(QList<QNetworkCookie> const& cookies);
+
+        /*
+         * Apply the changes to the cookies of the file and write them.
+         * Return false if the file cannot be written.
+         */
+        static bool write(QString const& filePath, QHash<QString, QNetworkCookie> const& modified, QSet<QString> const& deleted, QList<QNetworkCookie>& cookies);
+
+        /*
+         * Forget the written changes which were not made again since, and replace the cookies by the ones of the file,
+         * keeping the changes not written yet.
+         */
+        void written(QHash<QString, QNetworkCookie> const& modified, QSet<QString> const& deleted, QList<QNetworkCookie> const& cookies);
+};
+
+#endif
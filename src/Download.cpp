@@ -0,0 +1,350 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <fcntl.h>
+
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QTextStream>
+
+#include "Download.hpp"
+
+Download::Download(QUrl const& initialURL, QString const& initialPath, QNetworkAccessManager* initialNetworkAccessManager, QObject* parent) : QObject(parent), readyRead(), file(), networkAccessManager(initialNetworkAccessManager), path(initialPath), segments(), url(initialURL) {
+}
+
+Download::~Download() {
+    close();
+}
+
+void Download::checkCompletion() {
+    for(Segment const& segment : segments) {
+        if(nullptr != segment.reply) {
+            return;
+        }
+    }
+
+    close();
+    QFile::remove(path);
+    QFile::rename(partPath(), path);
+    QFile::remove(statePath());
+    finished = true;
+}
+
+void Download::checkRange(int index) {
+    Segment& segment = segments[index];
+    if(not rangesAccepted or nullptr == map or nullptr == segment.reply) {
+        return;
+    }
+
+    int status{segment.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()};
+    QByteArray range{"bytes " + QByteArray::number(segment.position) + "-" + QByteArray::number(segment.end - 1) + "/"};
+    if(206 == status and segment.reply->rawHeader("Content-Range").startsWith(range)) {
+        return;
+    }
+    if(200 != status and 206 != status) {
+        //The error page must not be written in the segment: the reply is retried.
+        segment.reply->abort();
+        return;
+    }
+
+    //A server ignoring the range sends the whole file, which would overrun the segment.
+    qWarning("The server of %s ignores the ranges: downloading through a single connection", qPrintable(url.toString()));
+    for(Segment& other : segments) {
+        if(nullptr != other.reply) {
+            disconnect(other.reply, nullptr, this, nullptr);
+            other.reply->abort();
+            other.reply->deleteLater();
+            other.reply = nullptr;
+        }
+    }
+    rangesAccepted = false;
+    segments = {{0, size, nullptr, 0}};
+    requestSegment(0);
+}
+
+void Download::close() {
+    for(Segment& segment : segments) {
+        if(nullptr != segment.reply) {
+            disconnect(segment.reply, nullptr, this, nullptr);
+            segment.reply->abort();
+            segment.reply->deleteLater();
+            segment.reply = nullptr;
+        }
+    }
+
+    if(nullptr != map) {
+        file.unmap(map);
+        map = nullptr;
+    }
+    file.close();
+}
+
+QString Download::fileName() const {
+    return QFileInfo(path).fileName();
+}
+
+void Download::headFinished(QNetworkReply* reply) {
+    reply->deleteLater();
+    if(QNetworkReply::NoError != reply->error()) {
+        qWarning("Cannot download %s: %s", qPrintable(url.toString()), qPrintable(reply->errorString()));
+        finished = true;
+        return;
+    }
+
+    url = reply->url();
+    size = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+    rangesAccepted = "bytes" == reply->rawHeader("Accept-Ranges");
+    file.setFileName(partPath());
+
+    if(size > 0) {
+        bool resumed{loadState()};
+        if(not file.open(QIODevice::ReadWrite)) {
+            qWarning("Cannot open %s", qPrintable(partPath()));
+            finished = true;
+            return;
+        }
+        //A stale part file of a larger download would leave trailing bytes: posix_fallocate() never shrinks.
+        if(not resumed and not file.resize(size)) {
+            qWarning("Cannot resize %s", qPrintable(partPath()));
+        }
+        //Reserve the blocks now to avoid fragmenting the file while the segments are written.
+        if(0 != posix_fallocate(file.handle(), 0, size)) {
+            file.resize(size);
+        }
+        map = file.map(0, size);
+        if(nullptr == map) {
+            qWarning("Cannot map %s", qPrintable(partPath()));
+            close();
+            finished = true;
+            return;
+        }
+        if(not resumed) {
+            split();
+        }
+    }
+    else {
+        //Unknown size: stream the response through a single connection.
+        file.open(QIODevice::WriteOnly);
+        segments = {{0, -1, nullptr, 0}};
+    }
+
+    for(int i{0} ; i < segments.size() ; i++) {
+        if(segments[i].position != segments[i].end) {
+            requestSegment(i);
+        }
+    }
+    checkCompletion();
+}
+
+bool Download::isFinished() const {
+    return finished;
+}
+
+bool Download::loadState() {
+    QFile stateFile{statePath()};
+    if(not rangesAccepted or not QFile::exists(partPath()) or not stateFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QTextStream stream{&stateFile};
+    if(stream.readLine() != url.toString() or stream.readLine().toLongLong() != size) {
+        return false;
+    }
+
+    segments.clear();
+    while(not stream.atEnd()) {
+        QStringList values{stream.readLine().split(' ')};
+        if(2 == values.size()) {
+            segments.append({values[0].toLongLong(), values[1].toLongLong(), nullptr, 0});
+        }
+    }
+    return not segments.isEmpty();
+}
+
+QString Download::partPath() const {
+    return path + ".part";
+}
+
+qint64 Download::received() const {
+    if(size <= 0) {
+        return segments.isEmpty() ? 0 : segments[0].position;
+    }
+
+    qint64 remaining{0};
+    for(Segment const& segment : segments) {
+        remaining += segment.end - segment.position;
+    }
+    return size - remaining;
+}
+
+void Download::requestSegment(int index) {
+    Segment& segment = segments[index];
+    QNetworkRequest request{url};
+    //A compressed transfer would not match the offsets of the file.
+    request.setRawHeader("Accept-Encoding", "identity");
+    if(rangesAccepted) {
+        QByteArray range{"bytes=" + QByteArray::number(segment.position) + "-"};
+        if(segment.end > 0) {
+            range += QByteArray::number(segment.end - 1);
+        }
+        request.setRawHeader("Range", range);
+    }
+    else {
+        segment.position = 0;
+    }
+
+    segment.reply = networkAccessManager->get(request);
+    segment.reply->setReadBufferSize(readBufferSize);
+    connect(segment.reply, &QNetworkReply::metaDataChanged, this, [this, index]() {
+        checkRange(index);
+    });
+    connect(segment.reply, &QNetworkReply::readyRead, this, [this]() {
+        if(readyRead) {
+            readyRead();
+        }
+    });
+    connect(segment.reply, &QNetworkReply::finished, this, [this, index]() {
+        segmentFinished(index);
+    });
+}
+
+void Download::saveState() {
+    if(not rangesAccepted or size <= 0 or finished) {
+        return;
+    }
+
+    QSaveFile stateFile{statePath()};
+    if(stateFile.open(QIODevice::WriteOnly)) {
+        QTextStream stream{&stateFile};
+        stream << url.toString() << '\n' << size << '\n';
+        for(Segment const& segment : segments) {
+            stream << segment.position << ' ' << segment.end << '\n';
+        }
+        stream.flush();
+        stateFile.commit();
+    }
+}
+
+void Download::segmentFinished(int index) {
+    Segment& segment = segments[index];
+    //With a rate limit, the data can still be buffered when the reply finishes: transfer() will call this method again.
+    if(nullptr == segment.reply or ((-1 == segment.end or segment.position < segment.end) and segment.reply->bytesAvailable() > 0)) {
+        return;
+    }
+
+    QNetworkReply::NetworkError error{segment.reply->error()};
+    QString errorString{segment.reply->errorString()};
+    segment.reply->deleteLater();
+    segment.reply = nullptr;
+
+    bool complete{-1 == segment.end ? QNetworkReply::NoError == error : segment.position >= segment.end};
+    if(not complete) {
+        if(-1 != segment.end and segment.retries < MAX_RETRIES) {
+            segment.retries++;
+            requestSegment(index);
+        }
+        else {
+            qWarning("Download of %s interrupted: %s", qPrintable(url.toString()), qPrintable(errorString));
+            saveState();
+            close();
+            finished = true;
+        }
+        return;
+    }
+
+    checkCompletion();
+}
+
+void Download::setReadBufferSize(qint64 bufferSize) {
+    readBufferSize = bufferSize;
+    for(Segment const& segment : segments) {
+        if(nullptr != segment.reply) {
+            segment.reply->setReadBufferSize(readBufferSize);
+        }
+    }
+}
+
+void Download::split() {
+    int count{1};
+    if(rangesAccepted) {
+        count = int(std::max<qint64>(1, std::min<qint64>(connections, size / MIN_SEGMENT_SIZE)));
+    }
+
+    qint64 segmentSize{size / count};
+    segments.clear();
+    for(int i{0} ; i < count ; i++) {
+        qint64 start{i * segmentSize};
+        segments.append({start, i == count - 1 ? size : start + segmentSize, nullptr, 0});
+    }
+}
+
+void Download::start(int connectionCount) {
+    connections = connectionCount;
+    QNetworkRequest request{url};
+    request.setAttribute(QNetworkRequest::FollowRedirectsAttribute, true);
+    request.setRawHeader("Accept-Encoding", "identity");
+    QNetworkReply* reply{networkAccessManager->head(request)};
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+        headFinished(reply);
+    });
+}
+
+QString Download::statePath() const {
+    return path + ".state";
+}
+
+qint64 Download::total() const {
+    return size;
+}
+
+qint64 Download::transfer(qint64 maxBytes) {
+    qint64 moved{0};
+    for(int i{0} ; i < segments.size() ; i++) {
+        Segment& segment = segments[i];
+        if(nullptr == segment.reply) {
+            continue;
+        }
+
+        while(moved < maxBytes and segment.reply->bytesAvailable() > 0) {
+            qint64 count{std::min(segment.reply->bytesAvailable(), maxBytes - moved)};
+            qint64 read{0};
+            if(nullptr != map) {
+                //Read straight into the mapped file to avoid an intermediate buffer.
+                count = std::min(count, segment.end - segment.position);
+                if(count <= 0) {
+                    break;
+                }
+                read = segment.reply->read(reinterpret_cast<char*>(map + segment.position), count);
+            }
+            else {
+                read = file.write(segment.reply->read(count));
+            }
+            if(read <= 0) {
+                break;
+            }
+            segment.position += read;
+            moved += read;
+        }
+
+        if(segment.reply->isFinished()) {
+            segmentFinished(i);
+        }
+    }
+    return moved;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DOWNLOAD_HPP
+#define DOWNLOAD_HPP
+
+#include <functional>
+
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QUrl>
+#include <QVector>
+
+/*
+ * File downloaded over several connections using HTTP ranges.
+ * The data is written in a preallocated memory-mapped file and the progress is saved next to it so that an
+ * interrupted download can be resumed.
+ */
+class Download : public QObject {
+    public:
+        Download(QUrl const& initialURL, QString const& initialPath, QNetworkAccessManager* initialNetworkAccessManager, QObject* parent = nullptr);
+
+        Download(Download const&) = delete;
+
+        Download& operator=(Download const&) = delete;
+
+        virtual ~Download();
+
+        /*
+         * Get the downloaded file name.
+         */
+        QString fileName() const;
+
+        /*
+         * Check if the download is over, either completed or failed.
+         */
+        bool isFinished() const;
+
+        /*
+         * Get the number of bytes received.
+         */
+        qint64 received() const;
+
+        /*
+         * Save the progress to resume the download later.
+         */
+        void saveState();
+
+        /*
+         * Set the size of the read buffer of the connections (0 means unlimited).
+         */
+        void setReadBufferSize(qint64 size);
+
+        /*
+         * Start the download with at most connectionCount connections.
+         */
+        void start(int connectionCount);
+
+        /*
+         * Get the download size (0 if unknown).
+         */
+        qint64 total() const;
+
+        /*
+         * Move at most maxBytes bytes from the connections to the file and return the number of bytes moved.
+         */
+        qint64 transfer(qint64 maxBytes);
+
+        /*
+         * Called when data is available on a connection.
+         */
+        std::function<void()> readyRead;
+
+    private:
+        struct Segment {
+            qint64 position;
+            qint64 end;
+            QNetworkReply* reply;
+            int retries;
+        };
+
+        static int const MAX_RETRIES = 3;
+        static qint64 const MIN_SEGMENT_SIZE = 1024 * 1024;
+
+        int connections = 1;
+        QFile file;
+        bool finished = false;
+        uchar* map = nullptr;
+        QNetworkAccessManager* networkAccessManager;
+        QString path;
+        qint64 readBufferSize = 0;
+        bool rangesAccepted = false;
+        QVector<Segment> segments;
+        qint64 size = 0;
+        QUrl url;
+
+        /*
+         * Complete the download if every segment is done.
+         */
+        void checkCompletion();
+
+        /*
+         * Check that a segment reply holds the requested range, or download the file through a single connection.
+         */
+        void checkRange(int index);
+
+        /*
+         * Close the file and stop every connection.
+         */
+        void close();
+
+        /*
+         * Head request finished event.
+         */
+        void headFinished(QNetworkReply* reply);
+
+        /*
+         * Load the progress of a previous download of the same URL.
+         */
+        bool loadState();
+
+        /*
+         * Get the path of the partial file.
+         */
+        QString partPath() const;
+
+        /*
+         * Request the remaining bytes of a segment.
+         */
+        void requestSegment(int index);
+
+        /*
+         * Segment reply finished event.
+         */
+        void segmentFinished(int index);
+
+        /*
+         * Split the file in segments.
+         */
+        void split();
+
+        /*
+         * Get the path of the progress file.
+         */
+        QString statePath() const;
+};
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "DownloadManager.hpp"
+
+DownloadManager::DownloadManager(QNetworkAccessManager* initialNetworkAccessManager, QString const& initialDirectory, QObject* parent) : QObject(parent), progressChanged(), directory(initialDirectory), downloads(), networkAccessManager(initialNetworkAccessManager), timer() {
+    timer.setInterval(TICK_INTERVAL);
+    connect(&timer, &QTimer::timeout, this, &DownloadManager::tick);
+}
+
+QString DownloadManager::availablePath(QUrl const& url) const {
+    QString name{QFileInfo(url.path()).fileName()};
+    if(name.isEmpty()) {
+        name = "download";
+    }
+
+    QDir downloadDirectory{directory};
+    QString path{downloadDirectory.filePath(name)};
+    //An existing partial file is resumed.
+    if(QFile::exists(path + ".state")) {
+        return path;
+    }
+
+    QFileInfo info{name};
+    QString suffix{info.completeSuffix().isEmpty() ? "" : "." + info.completeSuffix()};
+    for(int i{1} ; QFile::exists(path) ; i++) {
+        path = downloadDirectory.filePath(info.baseName() + " (" + QString::number(i) + ")" + suffix);
+    }
+    return path;
+}
+
+void DownloadManager::download(QUrl const& url) {
+    Download* download{new Download(url, availablePath(url), networkAccessManager, this)};
+    download->readyRead = [this, download]() {
+        if(0 == rateLimit) {
+            download->transfer(std::numeric_limits<qint64>::max());
+        }
+    };
+    if(rateLimit > 0) {
+        download->setReadBufferSize(std::max<qint64>(16384, rateLimit * TICK_INTERVAL / 1000));
+    }
+    downloads.append(download);
+    download->start(connectionCount);
+    timer.start();
+    updateProgress();
+}
+
+void DownloadManager::setConnectionCount(int count) {
+    connectionCount = std::max(1, count);
+}
+
+void DownloadManager::setRateLimit(qint64 bytesPerSecond) {
+    rateLimit = std::max<qint64>(0, bytesPerSecond);
+    for(Download* download : downloads) {
+        download->setReadBufferSize(rateLimit > 0 ? std::max<qint64>(16384, rateLimit * TICK_INTERVAL / 1000) : 0);
+    }
+}
+
+void DownloadManager::tick() {
+    if(0 == rateLimit) {
+        transferAll();
+    }
+    else if(not downloads.isEmpty()) {
+        qint64 budget{rateLimit * TICK_INTERVAL / 1000};
+        for(Download* download : downloads) {
+            budget -= download->transfer(budget / downloads.size() + 1);
+        }
+        //Give what the idle downloads did not use to the others.
+        for(Download* download : downloads) {
+            if(budget <= 0) {
+                break;
+            }
+            budget -= download->transfer(budget);
+        }
+    }
+
+    tickCount = (tickCount + 1) % SAVE_INTERVAL;
+    if(0 == tickCount) {
+        for(Download* download : downloads) {
+            download->saveState();
+        }
+    }
+
+    updateProgress();
+}
+
+void DownloadManager::transferAll() {
+    for(Download* download : downloads) {
+        download->transfer(std::numeric_limits<qint64>::max());
+    }
+}
+
+void DownloadManager::updateProgress() {
+    qint64 received{0};
+    qint64 total{0};
+    QStringList names;
+    for(auto it(downloads.begin()) ; it != downloads.end() ; ) {
+        Download* download{*it};
+        if(download->isFinished()) {
+            download->deleteLater();
+            it = downloads.erase(it);
+        }
+        else {
+            received += download->received();
+            total += download->total();
+            names << download->fileName();
+            it++;
+        }
+    }
+
+    if(downloads.isEmpty()) {
+        timer.stop();
+    }
+
+    if(progressChanged) {
+        progressChanged(received, total, names);
+    }
+}
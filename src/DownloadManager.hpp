@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DOWNLOADMANAGER_HPP
+#define DOWNLOADMANAGER_HPP
+
+#include <functional>
+
+#include <QList>
+#include <QTimer>
+
+#include "Download.hpp"
+
+/*
+ * Manager of the downloads of a window, sharing a bandwidth limit between them.
+ */
+class DownloadManager : public QObject {
+    public:
+        DownloadManager(QNetworkAccessManager* initialNetworkAccessManager, QString const& initialDirectory, QObject* parent = nullptr);
+
+        DownloadManager(DownloadManager const&) = delete;
+
+        DownloadManager& operator=(DownloadManager const&) = delete;
+
+        /*
+         * Download the file at the URL in the download directory.
+         */
+        void download(QUrl const& url);
+
+        /*
+         * Set the maximum number of connections per download.
+         */
+        void setConnectionCount(int count);
+
+        /*
+         * Set the bandwidth limit in bytes per second (0 means unlimited).
+         */
+        void setRateLimit(qint64 bytesPerSecond);
+
+        /*
+         * Called when the progress changes with the number of bytes received, the total size and the name of the
+         * files being downloaded (empty when every download is over).
+         */
+        std::function<void(qint64, qint64, QStringList const&)> progressChanged;
+
+    private:
+        static int const SAVE_INTERVAL = 10;
+        static int const TICK_INTERVAL = 100;
+
+        int connectionCount = 4;
+        QString directory;
+        QList<Download*> downloads;
+        QNetworkAccessManager* networkAccessManager;
+        qint64 rateLimit = 0;
+        int tickCount = 0;
+        QTimer timer;
+
+        /*
+         * Get a path in the download directory which does not exist yet for the URL.
+         */
+        QString availablePath(QUrl const& url) const;
+
+        /*
+         * Move the available data of the downloads to their files within the bandwidth limit.
+         */
+        void tick();
+
+        /*
+         * Move every available data of the downloads to their files.
+         */
+        void transferAll();
+
+        /*
+         * Report the progress and remove the finished downloads.
+         */
+        void updateProgress();
+};
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <QBuffer>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QImageReader>
+#include <QtConcurrentRun>
+
+#include "DownscaledImageReply.hpp"
+
+DownscaledImageReply::DownscaledImageReply(QNetworkReply* originalReply, QSize const& initialMaximumSize, QObject* parent) : QNetworkReply(parent), content(), maximumSize(initialMaximumSize), original(originalReply) {
+    original->setParent(this);
+    setRequest(original->request());
+    setUrl(original->url());
+    setOperation(original->operation());
+    connect(original, &QNetworkReply::downloadProgress, this, &QNetworkReply::downloadProgress);
+    connect(original, &QNetworkReply::finished, this, &DownscaledImageReply::originalFinished);
+}
+
+void DownscaledImageReply::abort() {
+    original->abort();
+}
+
+qint64 DownscaledImageReply::bytesAvailable() const {
+    return content.size() - position + QNetworkReply::bytesAvailable();
+}
+
+DownscaledImageReply::Downscaled DownscaledImageReply::downscale(QByteArray data, QSize const& maximumSize) {
+    static QList<QByteArray> const FORMATS{"bmp", "jpeg", "png", "webp"};
+    Downscaled result;
+    QBuffer buffer{&data};
+    QImageReader reader{&buffer};
+    QByteArray format{reader.format()};
+    QSize size{reader.size()};
+    if(not FORMATS.contains(format) or not size.isValid() or (size.width() <= maximumSize.width() and size.height() <= maximumSize.height())) {
+        return result;
+    }
+    //Only the first frame of an animation would be decoded.
+    if(reader.supportsAnimation() and 1 != reader.imageCount()) {
+        return result;
+    }
+
+    //The JPEG decoder scales while decoding, the other ones decode the full bitmap first.
+    QSize scaledSize{size.scaled(maximumSize, Qt::KeepAspectRatio)};
+    reader.setScaledSize(scaledSize);
+    QImage image{reader.read()};
+    if(image.isNull()) {
+        return result;
+    }
+
+    //The image keeps its format: JPEG would blur the screenshots and the diagrams.
+    QBuffer output{&result.content};
+    if(not image.save(&output, format.constData(), "jpeg" == format ? 90 : -1)) {
+        result.content.clear();
+        return result;
+    }
+    result.format = format;
+    result.savedMemory = (qint64(size.width()) * size.height() - qint64(scaledSize.width()) * scaledSize.height()) * 4;
+    return result;
+}
+
+bool DownscaledImageReply::isSequential() const {
+    return true;
+}
+
+void DownscaledImageReply::originalFinished() {
+    for(QByteArray const& header : original->rawHeaderList()) {
+        setRawHeader(header, original->rawHeader(header));
+    }
+    static QList<QNetworkRequest::Attribute> const ATTRIBUTES{
+        QNetworkRequest::HttpStatusCodeAttribute,
+        QNetworkRequest::HttpReasonPhraseAttribute,
+        QNetworkRequest::RedirectionTargetAttribute,
+        QNetworkRequest::ConnectionEncryptedAttribute,
+        QNetworkRequest::SourceIsFromCacheAttribute,
+        QNetworkRequest::HttpPipeliningWasUsedAttribute,
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+        QNetworkRequest::HTTP2WasUsedAttribute,
+#endif
+    };
+    for(QNetworkRequest::Attribute attribute : ATTRIBUTES) {
+        setAttribute(attribute, original->attribute(attribute));
+    }
+    content = original->readAll();
+
+    if(QNetworkReply::NoError != original->error()) {
+        setError(original->error(), original->errorString());
+        emit error(original->error());
+        serve();
+        return;
+    }
+
+    //The image is decoded in a worker thread: the watcher is deleted with the reply if it is deleted before.
+    QFutureWatcher<Downscaled>* watcher{new QFutureWatcher<Downscaled>(this)};
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher]() {
+        Downscaled downscaled{watcher->result()};
+        watcher->deleteLater();
+        if(not downscaled.content.isEmpty()) {
+            content = downscaled.content;
+            setHeader(QNetworkRequest::ContentTypeHeader, "image/" + downscaled.format);
+            setAttribute(SAVED_MEMORY_ATTRIBUTE, downscaled.savedMemory);
+        }
+        serve();
+    });
+    watcher->setFuture(QtConcurrent::run(&DownscaledImageReply::downscale, content, maximumSize));
+}
+
+qint64 DownscaledImageReply::readData(char* data, qint64 maxSize) {
+    qint64 length{std::min(maxSize, content.size() - position)};
+    if(length <= 0) {
+        return -1;
+    }
+    std::memcpy(data, content.constData() + position, size_t(length));
+    position += length;
+    return length;
+}
+
+void DownscaledImageReply::serve() {
+    //The content is already decompressed by the original reply.
+    setHeader(QNetworkRequest::ContentLengthHeader, content.size());
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    setFinished(true);
+    emit metaDataChanged();
+    emit readyRead();
+    emit finished();
+}
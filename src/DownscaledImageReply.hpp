@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DOWNSCALEDIMAGEREPLY_HPP
+#define DOWNSCALEDIMAGEREPLY_HPP
+
+#include <QNetworkReply>
+#include <QSize>
+
+/*
+ * Reply serving an image downscaled to a maximum size, so that WebKit does not decode and keep the full bitmap.
+ * The original reply is read until it is finished: the other resources are served unchanged.
+ */
+class DownscaledImageReply : public QNetworkReply {
+    public:
+        DownscaledImageReply(QNetworkReply* originalReply, QSize const& initialMaximumSize, QObject* parent = nullptr);
+
+        DownscaledImageReply(DownscaledImageReply const&) = delete;
+
+        DownscaledImageReply& operator=(DownscaledImageReply const&) = delete;
+
+        /*
+         * Attribute holding the decoded memory in bytes saved by downscaling the image.
+         */
+        static QNetworkRequest::Attribute const SAVED_MEMORY_ATTRIBUTE = QNetworkRequest::User;
+
+        virtual void abort();
+
+        virtual qint64 bytesAvailable() const;
+
+        virtual bool isSequential() const;
+
+    protected:
+        virtual qint64 readData(char* data, qint64 maxSize);
+
+    private:
+        struct Downscaled {
+            QByteArray content;
+            QByteArray format;
+            qint64 savedMemory = 0;
+        };
+
+        QByteArray content;
+        QSize maximumSize;
+        QNetworkReply* original;
+        qint64 position = 0;
+
+        /*
+         * Downscale the image if it is larger than the maximum size, keeping its format (an empty content otherwise).
+         * Called in a worker thread.
+         */
+        static Downscaled downscale(QByteArray data, QSize const& maximumSize);
+
+        /*
+         * Copy the response of the original reply and serve its content.
+         */
+        void originalFinished();
+
+        /*
+         * Serve the content.
+         */
+        void serve();
+};
+
+#endif
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "FrameTimer.hpp"
+
+FrameTimer::FrameTimer() : frameTimed(), inputTimer(), latencies(), timer(), times() {
+}
+
+void FrameTimer::input() {
+    //The latency of the first input not presented yet is the one seen by the user.
+    if(not inputTimer.isValid()) {
+        inputTimer.start();
+    }
+}
+
+QString FrameTimer::report() const {
+    if(times.isEmpty()) {
+        return "no frame";
+    }
+    return QString("%1 frames: %2; %3 inputs presented: %4")
+        .arg(times.size())
+        .arg(summary(times))
+        .arg(latencies.size())
+        .arg(latencies.isEmpty() ? "no latency" : summary(latencies));
+}
+
+void FrameTimer::start() {
+    timer.start();
+}
+
+void FrameTimer::stop() {
+    times.append(timer.nsecsElapsed());
+    if(inputTimer.isValid()) {
+        //An input without visible effect would be measured at the next unrelated frame.
+        qint64 latency{inputTimer.nsecsElapsed()};
+        if(latency < MAX_LATENCY) {
+            latencies.append(latency);
+        }
+        inputTimer.invalidate();
+    }
+    if(frameTimed) {
+        frameTimed();
+    }
+}
+
+QString FrameTimer::summary(QVector<qint64> const& durations) {
+    QVector<qint64> sorted{durations};
+    std::sort(sorted.begin(), sorted.end());
+    qint64 total{0};
+    for(qint64 duration : sorted) {
+        total += duration;
+    }
+
+    auto milliseconds = [](qint64 nanoseconds) {
+        return QString::number(double(nanoseconds) / 1e6, 'f', 2);
+    };
+    return QString("mean %1 ms, median %2 ms, 95th percentile %3 ms, max %4 ms")
+        .arg(milliseconds(total / sorted.size()))
+        .arg(milliseconds(sorted[sorted.size() / 2]))
+        .arg(milliseconds(sorted[sorted.size() * 95 / 100]))
+        .arg(milliseconds(sorted.last()));
+}
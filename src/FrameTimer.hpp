@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAMETIMER_HPP
+#define FRAMETIMER_HPP
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+/*
+ * Measure the time taken to paint the frames of a view, and the latency from an input to the end of the next frame.
+ * The paint time depends on the backend: the tiled one rasterizes its tiles outside of the paint events. The latency
+ * is the same quantity in both backends.
+ */
+class FrameTimer {
+    public:
+        FrameTimer();
+
+        /*
+         * Record an input, presented by the next frame.
+         */
+        void input();
+
+        /*
+         * Get a summary of the frame times and of the input latencies.
+         */
+        QString report() const;
+
+        /*
+         * Start measuring a frame.
+         */
+        void start();
+
+        /*
+         * Stop measuring the current frame.
+         */
+        void stop();
+
+        /*
+         * Called when a frame has been painted.
+         */
+        std::function<void()> frameTimed;
+
+    private:
+        static qint64 const MAX_LATENCY = 1000000000;
+
+        QElapsedTimer inputTimer;
+        QVector<qint64> latencies;
+        QElapsedTimer timer;
+        QVector<qint64> times;
+
+        /*
+         * Get a summary of the durations in nanoseconds.
+         */
+        static QString summary(QVector<qint64> const& durations);
+};
+
+#endif
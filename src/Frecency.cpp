@@ -0,0 +1,137 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <QDateTime>
+#include <QFile>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QTextStream>
+
+#include "Frecency.hpp"
+
+Frecency::Frecency(QString const& initialPath) : entries(), mutex(), path(initialPath) {
+}
+
+void Frecency::add(QHash<QString, Entry>& scores, QString const& entryKey, double score, qint64 time) {
+    auto it(scores.find(entryKey));
+    if(it == scores.end()) {
+        scores[entryKey] = {score, time};
+    }
+    else {
+        qint64 latest{std::max(it->time, time)};
+        it->score = decayed(*it, latest) + decayed({score, time}, latest);
+        it->time = latest;
+    }
+}
+
+void Frecency::compact() {
+    //A visit appended by another window while compacting can be lost, which only affects the ranking.
+    QLockFile lock{path + ".lock"};
+    if(not lock.tryLock(100)) {
+        return;
+    }
+
+    QHash<QString, Entry> scores;
+    {
+        std::lock_guard<std::mutex> entriesLock{mutex};
+        scores = entries;
+    }
+
+    QSaveFile file{path};
+    if(file.open(QIODevice::WriteOnly)) {
+        QTextStream stream{&file};
+        for(auto it(scores.begin()) ; it != scores.end() ; it++) {
+            stream << it.key() << '\t' << it->score << '\t' << it->time << '\n';
+        }
+        stream.flush();
+        if(file.commit()) {
+            std::lock_guard<std::mutex> entriesLock{mutex};
+            lineCount = scores.size();
+        }
+    }
+}
+
+double Frecency::decayed(Entry const& entry, qint64 time) {
+    return entry.score * std::pow(0.5, double(time - entry.time) / HALF_LIFE);
+}
+
+QString Frecency::key(QString const& site, QString const& target) {
+    return site + '\t' + target;
+}
+
+void Frecency::load() {
+    QHash<QString, Entry> scores;
+    int lines{0};
+
+    QFile file{path};
+    if(not file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    QTextStream stream{&file};
+    while(not stream.atEnd()) {
+        QStringList fields{stream.readLine().split('\t')};
+        if(4 == fields.size()) {
+            add(scores, key(fields[0], fields[1]), fields[2].toDouble(), fields[3].toLongLong());
+            lines++;
+        }
+    }
+    file.close();
+
+    bool compacted{false};
+    {
+        //A visit made while loading can be counted twice, which only affects the ranking.
+        std::lock_guard<std::mutex> lock{mutex};
+        for(auto it(entries.begin()) ; it != entries.end() ; it++) {
+            add(scores, it.key(), it->score, it->time);
+        }
+        entries.swap(scores);
+        lineCount += lines;
+        compacted = lineCount > COMPACT_THRESHOLD and lineCount > 2 * entries.size();
+    }
+
+    if(compacted) {
+        compact();
+    }
+}
+
+double Frecency::score(QString const& site, QString const& target) const {
+    std::lock_guard<std::mutex> lock{mutex};
+    auto it(entries.find(key(site, target)));
+    if(it == entries.end()) {
+        return 0;
+    }
+    return decayed(*it, QDateTime::currentMSecsSinceEpoch() / 1000);
+}
+
+void Frecency::visit(QString const& site, QString const& target) {
+    qint64 now{QDateTime::currentMSecsSinceEpoch() / 1000};
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        add(entries, key(site, target), 1, now);
+        lineCount++;
+    }
+
+    //A single small append is atomic, so the windows do not need to lock the file.
+    QFile file{path};
+    if(file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        file.write(QString(key(site, target) + "\t1\t" + QString::number(now) + "\n").toUtf8());
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRECENCY_HPP
+#define FRECENCY_HPP
+
+#include <mutex>
+
+#include <QHash>
+#include <QString>
+
+/*
+ * Frecency of the targets followed on each site: the score of a target increases each time it is followed and
+ * decays with time.
+ * The visits are appended to the file, which is safe with several windows, and the file is compacted when loaded.
+ * The file is loaded in a background thread while the scores are used.
+ */
+class Frecency {
+    public:
+        Frecency(QString const& initialPath);
+
+        /*
+         * Load the scores from the file, and compact it if needed. Can be called from a background thread.
+         */
+        void load();
+
+        /*
+         * Get the current score of the target on the site.
+         */
+        double score(QString const& site, QString const& target) const;
+
+        /*
+         * Record that the target was followed on the site.
+         */
+        void visit(QString const& site, QString const& target);
+
+    private:
+        struct Entry {
+            double score;
+            qint64 time;
+        };
+
+        static int const COMPACT_THRESHOLD = 1000;
+        static constexpr double HALF_LIFE = 30 * 24 * 3600;
+
+        QHash<QString, Entry> entries;
+        int lineCount = 0;
+        mutable std::mutex mutex;
+        QString path;
+
+        /*
+         * Add the score to the entry of the scores.
+         */
+        static void add(QHash<QString, Entry>& scores, QString const& key, double score, qint64 time);
+
+        /*
+         * Rewrite the file with one line per entry.
+         */
+        void compact();
+
+        /*
+         * Get the score of the entry decayed to the time.
+         */
+        static double decayed(Entry const& entry, qint64 time);
+
+        /*
+         * Get the key of the target on the site.
+         */
+        static QString key(QString const& site, QString const& target);
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QSettings>
+#include <QWebFrame>
+
+#include "HeadlessRenderer.hpp"
+
+HeadlessRenderer::HeadlessRenderer(QStringList const& initialURLs, QString const& initialOutputDirectory, Format initialFormat, int jobs, int initialTimeout) : format(initialFormat), outputDirectory(initialOutputDirectory), output(stdout), siteProfiles(CONFIG_PATH + "/profiles.ini"), browserContext(CONFIG_PATH, siteProfiles), timeout(initialTimeout), totalTime(), urls(initialURLs), workers() {
+    outputDirectory.mkpath(".");
+
+    //The pages are loaded as in a window, with the cookies and the settings of the user.
+    QSettings config{CONFIG_PATH + "/config.ini", QSettings::IniFormat};
+    browserContext.loadConfig(config);
+    //The renderer does not start a new session: the session cookies of the running windows are kept.
+    browserContext.createNetworkAccessManager(true, this);
+
+    for(int i{0} ; i < std::max(1, jobs) ; i++) {
+        WebPage* page{browserContext.createPage(this)};
+        page->setViewportSize(VIEWPORT_SIZE);
+        page->mainFrame()->setScrollBarPolicy(Qt::Vertical, Qt::ScrollBarAlwaysOff);
+        page->mainFrame()->setScrollBarPolicy(Qt::Horizontal, Qt::ScrollBarAlwaysOff);
+
+        QTimer* timer{new QTimer(this)};
+        timer->setSingleShot(true);
+
+        workers.append({page, timer, -1, false, QElapsedTimer()});
+
+        connect(page->mainFrame(), &QWebFrame::loadFinished, this, [this, i](bool ok) {
+            pageFinished(i, ok);
+        });
+        connect(timer, &QTimer::timeout, this, [this, i]() {
+            //Stopping usually emits loadFinished() synchronously, which already finishes the page and loads the next one.
+            int index{workers[i].index};
+            workers[i].timedOut = true;
+            workers[i].page->triggerAction(QWebPage::Stop);
+            if(workers[i].index == index) {
+                pageFinished(i, false);
+            }
+        });
+    }
+}
+
+void HeadlessRenderer::loadNext(int workerIndex) {
+    Worker& worker = workers[workerIndex];
+    if(nextIndex < urls.size()) {
+        worker.index = nextIndex++;
+        worker.timedOut = false;
+        worker.elapsed.start();
+        worker.timer->start(timeout);
+        worker.page->mainFrame()->load(QUrl::fromUserInput(urls[worker.index]));
+        return;
+    }
+
+    for(Worker const& other : workers) {
+        if(-1 != other.index) {
+            return;
+        }
+    }
+    printStatistics();
+    QCoreApplication::exit(0 == failed + timedOut ? 0 : 1);
+}
+
+void HeadlessRenderer::pageFinished(int workerIndex, bool ok) {
+    Worker& worker = workers[workerIndex];
+    if(-1 == worker.index) {
+        return;
+    }
+
+    worker.timer->stop();
+    qint64 time{worker.elapsed.elapsed()};
+    totalPageTime += time;
+    maximumTime = std::max(maximumTime, time);
+
+    QString status{"ok"};
+    if(worker.timedOut) {
+        status = "timeout";
+        timedOut++;
+    }
+    else if(not ok) {
+        status = "failed";
+        failed++;
+    }
+    else {
+        succeeded++;
+    }
+
+    //A page which timed out is saved as rendered so far.
+    QString path{save(worker.page, worker.index)};
+    output << status << '\t' << time << " ms\t" << urls[worker.index] << '\t' << path << endl;
+
+    worker.index = -1;
+    loadNext(workerIndex);
+}
+
+void HeadlessRenderer::printStatistics() {
+    qint64 total{totalTime.elapsed()};
+    int count{urls.size()};
+    output << count << " pages in " << total << " ms (" << (total > 0 ? count * 1000.0 / total : 0.0) << " pages/s, "
+        << workers.size() << " workers): " << succeeded << " ok, " << failed << " failed, " << timedOut << " timed out; "
+        << "mean " << (count > 0 ? totalPageTime / count : 0) << " ms, max " << maximumTime << " ms per page" << endl;
+}
+
+QString HeadlessRenderer::save(WebPage* page, int index) {
+    QWebFrame* frame{page->mainFrame()};
+    QString baseName{QString("%1-%2").arg(index + 1, 4, 10, QChar('0')).arg(frame->url().host().isEmpty() ? "page" : frame->url().host())};
+
+    if(Format::PNG == format) {
+        QSize size{frame->contentsSize().expandedTo(VIEWPORT_SIZE)};
+        size.setHeight(std::min(size.height(), MAX_SCREENSHOT_HEIGHT));
+        page->setViewportSize(size);
+        QImage image{size, QImage::Format_ARGB32_Premultiplied};
+        image.fill(Qt::white);
+        QPainter painter{&image};
+        frame->render(&painter);
+        painter.end();
+        page->setViewportSize(VIEWPORT_SIZE);
+
+        QString path{outputDirectory.filePath(baseName + ".png")};
+        image.save(path);
+        return path;
+    }
+
+    QString path{outputDirectory.filePath(baseName + (Format::HTML == format ? ".html" : ".txt"))};
+    QFile file{path};
+    if(file.open(QIODevice::WriteOnly)) {
+        file.write((Format::HTML == format ? frame->toHtml() : frame->toPlainText()).toUtf8());
+    }
+    return path;
+}
+
+void HeadlessRenderer::start() {
+    totalTime.start();
+    for(int i{0} ; i < workers.size() ; i++) {
+        loadNext(i);
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HEADLESSRENDERER_HPP
+#define HEADLESSRENDERER_HPP
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+
+#include "BrowserContext.hpp"
+#include "SiteProfiles.hpp"
+#include "WebPage.hpp"
+
+/*
+ * Batch renderer loading a list of URLs with a pool of pages, without window.
+ * It uses the same site profiles and network stack as the windows.
+ */
+class HeadlessRenderer : public QObject {
+    public:
+        enum class Format {
+            HTML,
+            PNG,
+            TEXT
+        };
+
+        HeadlessRenderer(QStringList const& initialURLs, QString const& initialOutputDirectory, Format initialFormat, int jobs, int initialTimeout);
+
+        HeadlessRenderer(HeadlessRenderer const&) = delete;
+
+        HeadlessRenderer& operator=(HeadlessRenderer const&) = delete;
+
+        /*
+         * Start rendering: the application exits when every URL is rendered.
+         */
+        void start();
+
+    private:
+        struct Worker {
+            WebPage* page;
+            QTimer* timer;
+            int index;
+            bool timedOut;
+            QElapsedTimer elapsed;
+        };
+
+        QString const CONFIG_PATH = BrowserContext::defaultConfigPath();
+        QSize const VIEWPORT_SIZE{1280, 1024};
+        int const MAX_SCREENSHOT_HEIGHT = 16384;
+
+        int failed = 0;
+        Format format;
+        qint64 maximumTime = 0;
+        int nextIndex = 0;
+        QDir outputDirectory;
+        QTextStream output;
+        SiteProfiles siteProfiles;
+        BrowserContext browserContext;
+        int succeeded = 0;
+        int timedOut = 0;
+        int timeout;
+        QElapsedTimer totalTime;
+        qint64 totalPageTime = 0;
+        QStringList urls;
+        QVector<Worker> workers;
+
+        /*
+         * Load the next URL in the worker page.
+         */
+        void loadNext(int workerIndex);
+
+        /*
+         * Page load finished event.
+         */
+        void pageFinished(int workerIndex, bool ok);
+
+        /*
+         * Print the throughput statistics.
+         */
+        void printStatistics();
+
+        /*
+         * Save the rendering of the page and return the file path.
+         */
+        QString save(WebPage* page, int index);
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "HintGenerator.hpp"
+
+HintGenerator::HintGenerator(QString const& initialAlphabet) : alphabet() {
+    for(QChar character : initialAlphabet) {
+        if(character.isLetter() and not alphabet.contains(character.toLower())) {
+            alphabet.append(character.toLower());
+        }
+    }
+    if(alphabet.size() < 2) {
+        alphabet = "abcdefghijklmnopqrstuvwxyz";
+    }
+}
+
+QStringList HintGenerator::labels(QVector<double> const& weights) const {
+    struct Node {
+        double weight;
+        int target;
+        std::vector<int> children;
+    };
+
+    int const base{alphabet.size()};
+    int const targetCount{weights.size()};
+    QStringList result;
+    if(0 == targetCount) {
+        return result;
+    }
+    if(1 == targetCount) {
+        result << QString(alphabet[0]);
+        return result;
+    }
+
+    std::vector<Node> nodes;
+    typedef std::pair<double, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    for(int i{0} ; i < targetCount ; i++) {
+        nodes.push_back({std::max(0.0, weights[i]), i, {}});
+        queue.push({nodes.back().weight, i});
+    }
+    //Empty leaves make every internal node full, which the Huffman algorithm requires to be optimal.
+    while(0 != (nodes.size() - 1) % size_t(base - 1)) {
+        nodes.push_back({0.0, -1, {}});
+        queue.push({0.0, int(nodes.size()) - 1});
+    }
+
+    while(queue.size() > 1) {
+        Node parent{0.0, -1, {}};
+        for(int i{0} ; i < base ; i++) {
+            parent.children.push_back(queue.top().second);
+            parent.weight += queue.top().first;
+            queue.pop();
+        }
+        nodes.push_back(parent);
+        queue.push({parent.weight, int(nodes.size()) - 1});
+    }
+
+    for(int i{0} ; i < targetCount ; i++) {
+        result << QString();
+    }
+
+    std::vector<std::pair<int, QString>> stack{{queue.top().second, QString()}};
+    while(not stack.empty()) {
+        std::pair<int, QString> item{stack.back()};
+        stack.pop_back();
+        Node const& node = nodes[size_t(item.first)];
+        if(node.children.empty()) {
+            if(-1 != node.target) {
+                result[node.target] = item.second;
+            }
+            continue;
+        }
+
+        std::vector<int> children{node.children};
+        std::stable_sort(children.begin(), children.end(), [&nodes](int first, int second) {
+            return nodes[size_t(first)].weight > nodes[size_t(second)].weight;
+        });
+        for(size_t i{0} ; i < children.size() ; i++) {
+            stack.push_back({children[i], item.second + alphabet[int(i)]});
+        }
+    }
+    return result;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HINTGENERATOR_HPP
+#define HINTGENERATOR_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Generator of the follow labels.
+ * The labels form a prefix-free code minimizing the expected number of keystrokes (n-ary Huffman code), so that
+ * typing a label is enough to select its target and the most likely targets get the shortest labels.
+ */
+class HintGenerator {
+    public:
+        HintGenerator(QString const& initialAlphabet);
+
+        /*
+         * Generate a label for each target from its weight (how likely it is to be followed).
+         * The first characters of the alphabet are used for the most likely targets.
+         */
+        QStringList labels(QVector<double> const& weights) const;
+
+    private:
+        QString alphabet;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QRunnable>
+#include <QThread>
+
+#include "IdleScheduler.hpp"
+
+class IdleScheduler::BackgroundTask : public QRunnable {
+    public:
+        BackgroundTask(std::function<void()> const& initialTask, IdleScheduler* initialScheduler) : scheduler(initialScheduler), task(initialTask) {
+        }
+
+        BackgroundTask(BackgroundTask const&) = delete;
+
+        BackgroundTask& operator=(BackgroundTask const&) = delete;
+
+        virtual void run() {
+            //A thread with the idle priority only runs when no other thread needs the CPU.
+            QThread::currentThread()->setPriority(QThread::IdlePriority);
+            task();
+
+            //The runnable is deleted when this function returns.
+            IdleScheduler* owner{scheduler};
+            QMetaObject::invokeMethod(owner, [owner]() {
+                owner->backgroundTaskRunning = false;
+                owner->startBackgroundTask();
+            }, Qt::QueuedConnection);
+        }
+
+    private:
+        IdleScheduler* scheduler;
+        std::function<void()> task;
+};
+
+IdleScheduler::IdleScheduler(QObject* parent) : QObject(parent), backgroundTasks(), idle(false), idleTimer(), pool(), sliceTimer(), tasks() {
+    pool.setMaxThreadCount(1);
+    idleTimer.setSingleShot(true);
+    idleTimer.setInterval(500);
+    connect(&idleTimer, &QTimer::timeout, this, [this]() {
+        idle = true;
+        start();
+    });
+    connect(&sliceTimer, &QTimer::timeout, this, &IdleScheduler::runSlice);
+
+    //Every input event of the application is an activity.
+    QCoreApplication::instance()->installEventFilter(this);
+    idleTimer.start();
+}
+
+void IdleScheduler::activity() {
+    idle = false;
+    sliceTimer.stop();
+    idleTimer.start();
+}
+
+bool IdleScheduler::eventFilter(QObject* watched, QEvent* event) {
+    switch(event->type()) {
+        case QEvent::KeyPress:
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseMove:
+        case QEvent::Wheel:
+            activity();
+            break;
+        default:
+            break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void IdleScheduler::finishBackgroundTasks() {
+    pool.waitForDone();
+    while(not backgroundTasks.isEmpty()) {
+        backgroundTasks.dequeue()();
+    }
+}
+
+bool IdleScheduler::isIdle() const {
+    return idle;
+}
+
+void IdleScheduler::runSlice() {
+    QElapsedTimer timer;
+    timer.start();
+    while(idle and not tasks.isEmpty() and timer.elapsed() < SLICE) {
+        if(tasks.head()()) {
+            tasks.dequeue();
+        }
+    }
+
+    //The event loop runs between the slices, so that an input event preempts the tasks.
+    if(not idle or tasks.isEmpty()) {
+        sliceTimer.stop();
+    }
+}
+
+void IdleScheduler::schedule(std::function<bool()> const& step) {
+    tasks.enqueue(step);
+    start();
+}
+
+void IdleScheduler::scheduleInBackground(std::function<void()> const& task) {
+    backgroundTasks.enqueue(task);
+    start();
+}
+
+void IdleScheduler::setDelay(int delay) {
+    idleTimer.setInterval(delay);
+}
+
+void IdleScheduler::start() {
+    if(not idle) {
+        return;
+    }
+    if(not tasks.isEmpty() and not sliceTimer.isActive()) {
+        sliceTimer.start(0);
+    }
+    startBackgroundTask();
+}
+
+void IdleScheduler::startBackgroundTask() {
+    if(idle and not backgroundTaskRunning and not backgroundTasks.isEmpty()) {
+        backgroundTaskRunning = true;
+        pool.start(new BackgroundTask(backgroundTasks.dequeue(), this));
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IDLESCHEDULER_HPP
+#define IDLESCHEDULER_HPP
+
+#include <atomic>
+#include <functional>
+
+#include <QQueue>
+#include <QThreadPool>
+#include <QTimer>
+
+/*
+ * Run low-priority tasks while the user and the pages are idle.
+ * The application is idle when no input event was received and no page loaded for the delay.
+ * The tasks of the GUI thread run one step at a time in short slices and the background tasks run one at a time
+ * in a thread with the idle priority. The input events preempt the tasks: no new step nor background task starts
+ * until the next idle period.
+ */
+class IdleScheduler : public QObject {
+    public:
+        IdleScheduler(QObject* parent = nullptr);
+
+        IdleScheduler(IdleScheduler const&) = delete;
+
+        IdleScheduler& operator=(IdleScheduler const&) = delete;
+
+        /*
+         * Record an activity (like a page load) which delays the idle period.
+         */
+        void activity();
+
+        /*
+         * Run the background tasks still queued and wait for them, so that none is lost when the application quits.
+         */
+        void finishBackgroundTasks();
+
+        /*
+         * Check if the application is idle. Can be called from a background task to stop early.
+         */
+        bool isIdle() const;
+
+        /*
+         * Queue a task run on the GUI thread: the step is called until it returns true.
+         */
+        void schedule(std::function<bool()> const& step);
+
+        /*
+         * Queue a task run in a background thread.
+         */
+        void scheduleInBackground(std::function<void()> const& task);
+
+        /*
+         * Set the time in milliseconds without activity after which the application is idle.
+         */
+        void setDelay(int delay);
+
+    protected:
+        virtual bool eventFilter(QObject* watched, QEvent* event);
+
+    private:
+        class BackgroundTask;
+
+        static qint64 const SLICE = 5;
+
+        QQueue<std::function<void()>> backgroundTasks;
+        bool backgroundTaskRunning = false;
+        std::atomic<bool> idle;
+        QTimer idleTimer;
+        QThreadPool pool;
+        QTimer sliceTimer;
+        QQueue<std::function<bool()>> tasks;
+
+        /*
+         * Run the steps of the tasks for a slice.
+         */
+        void runSlice();
+
+        /*
+         * Start the tasks if the application is idle.
+         */
+        void start();
+
+        /*
+         * Start the next background task.
+         */
+        void startBackgroundTask();
+};
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <QtEndian>
+
+#include "IndexSegment.hpp"
+
+char const IndexSegment::MAGIC[] = "NVIX0001";
+
+IndexSegment::IndexSegment(QString const& path) : file(path) {
+    if(not file.open(QIODevice::ReadOnly) or file.size() < HEADER_SIZE) {
+        return;
+    }
+
+    size = file.size();
+    data = file.map(0, size);
+    if(nullptr == data or 0 != std::memcmp(data, MAGIC, 8)) {
+        data = nullptr;
+        return;
+    }
+
+    terms = qFromLittleEndian<quint32>(data + 8);
+    entriesOffset = qFromLittleEndian<quint64>(data + 16);
+    if(entriesOffset < HEADER_SIZE or entriesOffset > quint64(size) or quint64(terms) * ENTRY_SIZE > quint64(size) - entriesOffset) {
+        data = nullptr;
+        return;
+    }
+
+    //The terms and the postings of a truncated or corrupted segment could be read outside of the map.
+    for(quint32 i{0} ; i < terms ; i++) {
+        uchar const* termEntry{entry(i)};
+        quint64 termOffset{qFromLittleEndian<quint64>(termEntry)};
+        quint64 postingsOffset{qFromLittleEndian<quint64>(termEntry + 8)};
+        quint32 termLength{qFromLittleEndian<quint32>(termEntry + 16)};
+        quint32 postingsLength{qFromLittleEndian<quint32>(termEntry + 20)};
+        if(termOffset > entriesOffset or termLength > entriesOffset - termOffset or postingsOffset > entriesOffset or postingsLength > entriesOffset - postingsOffset) {
+            data = nullptr;
+            return;
+        }
+    }
+}
+
+IndexSegment::Postings IndexSegment::decode(uchar const* bytes, quint32 length) {
+    Postings postings;
+    quint64 document{0};
+    quint32 position{0};
+    while(position < length) {
+        quint64 values[2]{0, 0};
+        for(quint64& value : values) {
+            int shift{0};
+            while(position < length) {
+                uchar byte{bytes[position++]};
+                value |= quint64(byte & 0x7F) << shift;
+                shift += 7;
+                if(0 == (byte & 0x80)) {
+                    break;
+                }
+            }
+        }
+        document += values[0];
+        postings.append({document, quint32(values[1])});
+    }
+    return postings;
+}
+
+QByteArray IndexSegment::encode(Postings const& postings) {
+    QByteArray bytes;
+    quint64 previous{0};
+    for(Posting const& posting : postings) {
+        for(quint64 value : {posting.first - previous, quint64(posting.second)}) {
+            while(value >= 0x80) {
+                bytes.append(char((value & 0x7F) | 0x80));
+                value >>= 7;
+            }
+            bytes.append(char(value));
+        }
+        previous = posting.first;
+    }
+    return bytes;
+}
+
+uchar const* IndexSegment::entry(quint32 index) const {
+    return data + entriesOffset + quint64(index) * ENTRY_SIZE;
+}
+
+QPair<quint32, quint32> IndexSegment::find(QByteArray const& searchedTerm, bool prefix) const {
+    quint32 low{0};
+    quint32 high{terms};
+    while(low < high) {
+        quint32 middle{low + (high - low) / 2};
+        if(term(middle) < searchedTerm) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    quint32 end{low};
+    while(end < terms and (prefix ? term(end).startsWith(searchedTerm) : term(end) == searchedTerm)) {
+        end++;
+    }
+    return {low, end};
+}
+
+bool IndexSegment::isValid() const {
+    return nullptr != data;
+}
+
+IndexSegment::Postings IndexSegment::postings(quint32 index) const {
+    uchar const* termEntry{entry(index)};
+    quint64 offset{qFromLittleEndian<quint64>(termEntry + 8)};
+    quint32 length{qFromLittleEndian<quint32>(termEntry + 20)};
+    return decode(data + offset, length);
+}
+
+QByteArray IndexSegment::term(quint32 index) const {
+    uchar const* termEntry{entry(index)};
+    quint64 offset{qFromLittleEndian<quint64>(termEntry)};
+    quint32 length{qFromLittleEndian<quint32>(termEntry + 16)};
+    return QByteArray::fromRawData(reinterpret_cast<char const*>(data + offset), int(length));
+}
+
+quint32 IndexSegment::termCount() const {
+    return terms;
+}
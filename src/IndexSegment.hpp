@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDEXSEGMENT_HPP
+#define INDEXSEGMENT_HPP
+
+#include <QByteArray>
+#include <QFile>
+#include <QPair>
+#include <QVector>
+
+/*
+ * Immutable part of the full-text index, memory-mapped for the queries.
+ * Layout (little endian):
+ *     header: "NVIX0001", term count (32 bits), padding (32 bits), entry table offset (64 bits)
+ *     terms and postings
+ *     entry table sorted by term: term offset (64 bits), postings offset (64 bits), term length (32 bits),
+ *     postings length (32 bits)
+ * The postings are a list of (document delta, frequency) varints.
+ */
+class IndexSegment {
+    public:
+        typedef QPair<quint64, quint32> Posting;
+        typedef QVector<Posting> Postings;
+
+        static int const ENTRY_SIZE = 24;
+        static int const HEADER_SIZE = 24;
+        static char const MAGIC[];
+
+        IndexSegment(QString const& path);
+
+        IndexSegment(IndexSegment const&) = delete;
+
+        IndexSegment& operator=(IndexSegment const&) = delete;
+
+        /*
+         * Decode the postings.
+         */
+        static Postings decode(uchar const* data, quint32 length);
+
+        /*
+         * Encode the postings which must be sorted by document.
+         */
+        static QByteArray encode(Postings const& postings);
+
+        /*
+         * Get the range of the entries of the term (or of the terms starting with it if prefix is true).
+         */
+        QPair<quint32, quint32> find(QByteArray const& term, bool prefix) const;
+
+        /*
+         * Check if the segment was opened.
+         */
+        bool isValid() const;
+
+        /*
+         * Get the postings of the entry.
+         */
+        Postings postings(quint32 index) const;
+
+        /*
+         * Get the term of the entry.
+         */
+        QByteArray term(quint32 index) const;
+
+        /*
+         * Get the number of terms.
+         */
+        quint32 termCount() const;
+
+    private:
+        uchar const* data = nullptr;
+        quint64 entriesOffset = 0;
+        QFile file;
+        qint64 size = 0;
+        quint32 terms = 0;
+
+        /*
+         * Get the entry.
+         */
+        uchar const* entry(quint32 index) const;
+};
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QtEndian>
+
+#include "IndexSegmentWriter.hpp"
+
+IndexSegmentWriter::IndexSegmentWriter(QString const& path) : entries(), file(path) {
+    if(file.open(QIODevice::WriteOnly)) {
+        file.write(QByteArray(IndexSegment::HEADER_SIZE, '\0'));
+    }
+}
+
+void IndexSegmentWriter::add(QByteArray const& term, IndexSegment::Postings const& postings) {
+    QByteArray encodedPostings{IndexSegment::encode(postings)};
+
+    uchar entry[IndexSegment::ENTRY_SIZE];
+    qToLittleEndian<quint64>(position, entry);
+    qToLittleEndian<quint64>(position + quint64(term.size()), entry + 8);
+    qToLittleEndian<quint32>(quint32(term.size()), entry + 16);
+    qToLittleEndian<quint32>(quint32(encodedPostings.size()), entry + 20);
+    entries.append(reinterpret_cast<char const*>(entry), IndexSegment::ENTRY_SIZE);
+
+    file.write(term);
+    file.write(encodedPostings);
+    position += quint64(term.size() + encodedPostings.size());
+    termCount++;
+}
+
+bool IndexSegmentWriter::commit() {
+    file.write(entries);
+
+    uchar header[IndexSegment::HEADER_SIZE]{};
+    std::copy(IndexSegment::MAGIC, IndexSegment::MAGIC + 8, header);
+    qToLittleEndian<quint32>(termCount, header + 8);
+    qToLittleEndian<quint64>(position, header + 16);
+    file.seek(0);
+    file.write(reinterpret_cast<char const*>(header), IndexSegment::HEADER_SIZE);
+    return file.commit();
+}
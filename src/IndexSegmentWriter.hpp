@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDEXSEGMENTWRITER_HPP
+#define INDEXSEGMENTWRITER_HPP
+
+#include <QSaveFile>
+
+#include "IndexSegment.hpp"
+
+/*
+ * Writer streaming the terms of a new index segment to disk.
+ * The file only appears when committed.
+ */
+class IndexSegmentWriter {
+    public:
+        IndexSegmentWriter(QString const& path);
+
+        IndexSegmentWriter(IndexSegmentWriter const&) = delete;
+
+        IndexSegmentWriter& operator=(IndexSegmentWriter const&) = delete;
+
+        /*
+         * Add a term, which must come after the previous one, with its postings.
+         */
+        void add(QByteArray const& term, IndexSegment::Postings const& postings);
+
+        /*
+         * Write the entry table and the header, and move the file in place.
+         */
+        bool commit();
+
+    private:
+        QByteArray entries;
+        QSaveFile file;
+        quint64 position = IndexSegment::HEADER_SIZE;
+        quint32 termCount = 0;
+};
+
+#endif
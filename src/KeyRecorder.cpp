@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QKeyEvent>
+#include <QSaveFile>
+#include <QUrl>
+
+#include "KeyRecorder.hpp"
+
+KeyRecorder::KeyRecorder(QString const& filePath, QWidget* recordedWindow, QObject* parent) : QObject(parent), elapsedTimer(), lines(), path(filePath), window(recordedWindow) {
+    QCoreApplication::instance()->installEventFilter(this);
+    elapsedTimer.start();
+}
+
+KeyRecorder::~KeyRecorder() {
+    QSaveFile file{path};
+    if(not file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning("Cannot write the keys to %s", qPrintable(path));
+        return;
+    }
+    file.write(lines.join('\n').toUtf8());
+    file.write("\n");
+    if(not file.commit()) {
+        qWarning("Cannot write the keys to %s", qPrintable(path));
+    }
+}
+
+bool KeyRecorder::eventFilter(QObject* watched, QEvent* event) {
+    //A key event propagated to the parents of the focused widget is only recorded once.
+    QWidget* receiver{nullptr != QApplication::focusWidget() ? QApplication::focusWidget() : window};
+    if(QEvent::KeyPress == event->type() and watched == receiver and receiver->window() == window) {
+        QKeyEvent* keyEvent{static_cast<QKeyEvent*>(event)};
+        qint64 time{elapsedTimer.elapsed()};
+        lines.append(QString("%1 %2 %3 %4").arg(time - previousTime).arg(keyEvent->key()).arg(int(keyEvent->modifiers())).arg(QString::fromLatin1(QUrl::toPercentEncoding(keyEvent->text()))));
+        previousTime = time;
+    }
+    return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYRECORDER_HPP
+#define KEYRECORDER_HPP
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QStringList>
+#include <QWidget>
+
+/*
+ * Recorder of the keys pressed in a window, written to the file when the recorder is destroyed.
+ * Every line is a key: the delay since the previous key in milliseconds, the key code, the modifiers and the percent-encoded text.
+ */
+class KeyRecorder : public QObject {
+    public:
+        KeyRecorder(QString const& filePath, QWidget* recordedWindow, QObject* parent = nullptr);
+        ~KeyRecorder();
+
+        KeyRecorder(KeyRecorder const&) = delete;
+
+        KeyRecorder& operator=(KeyRecorder const&) = delete;
+
+    protected:
+        virtual bool eventFilter(QObject* watched, QEvent* event);
+
+    private:
+        QElapsedTimer elapsedTimer;
+        QStringList lines;
+        QString path;
+        qint64 previousTime = 0;
+        QWidget* window;
+};
+
+#endif
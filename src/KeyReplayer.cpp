@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QApplication>
+#include <QFile>
+#include <QKeyEvent>
+#include <QKeySequence>
+#include <QStringList>
+#include <QTextStream>
+#include <QTimer>
+#include <QUrl>
+
+#include "KeyReplayer.hpp"
+
+KeyReplayer::KeyReplayer(QString const& path, QWidget* replayedWindow, QObject* parent) : QObject(parent), finished(), keys(), latencies(), totalTimer(), window(replayedWindow) {
+    load(path);
+}
+
+void KeyReplayer::load(QString const& path) {
+    QFile file{path};
+    if(not file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning("Cannot read the keys from %s", qPrintable(path));
+        return;
+    }
+
+    QTextStream stream{&file};
+    while(not stream.atEnd()) {
+        QStringList fields{stream.readLine().split(' ')};
+        if(fields.size() < 3) {
+            continue;
+        }
+        QString text{fields.size() > 3 ? QUrl::fromPercentEncoding(fields[3].toLatin1()) : QString()};
+        keys.append({fields[0].toInt(), fields[1].toInt(), Qt::KeyboardModifiers(fields[2].toInt()), text});
+    }
+}
+
+void KeyReplayer::replay(RecordedKey const& recordedKey) {
+    QWidget* receiver{nullptr != QApplication::focusWidget() ? QApplication::focusWidget() : window};
+    QElapsedTimer timer;
+    timer.start();
+    QKeyEvent press{QEvent::KeyPress, recordedKey.key, recordedKey.modifiers, recordedKey.text};
+    QApplication::sendEvent(receiver, &press);
+    QKeyEvent release{QEvent::KeyRelease, recordedKey.key, recordedKey.modifiers, recordedKey.text};
+    QApplication::sendEvent(receiver, &release);
+
+    //A zero timer fires once the events posted while handling the key (layouts, repaints) are processed.
+    QTimer::singleShot(0, this, [this, timer]() {
+        latencies.append(timer.nsecsElapsed());
+        index++;
+        replayNext();
+    });
+}
+
+void KeyReplayer::replayNext() {
+    if(index >= keys.size()) {
+        if(finished) {
+            finished();
+        }
+        return;
+    }
+
+    RecordedKey recordedKey{keys[index]};
+    QTimer::singleShot(recordedKey.delay, this, [this, recordedKey]() {
+        replay(recordedKey);
+    });
+}
+
+QString KeyReplayer::report() const {
+    QStringList lines;
+    qint64 total{0};
+    for(int i{0} ; i < latencies.size() ; i++) {
+        RecordedKey const& recordedKey{keys[i]};
+        QString name{recordedKey.text.trimmed().isEmpty() ? QKeySequence(int(recordedKey.modifiers) | recordedKey.key).toString() : recordedKey.text};
+        lines.append(QString("%1: %2 ms").arg(name).arg(double(latencies[i]) / 1000000, 0, 'f', 2));
+        total += latencies[i];
+    }
+    lines.append(QString("%1 keys handled in %2 ms, replayed in %3 ms").arg(latencies.size()).arg(double(total) / 1000000, 0, 'f', 2).arg(totalTimer.elapsed()));
+    return lines.join('\n');
+}
+
+void KeyReplayer::start() {
+    if(started) {
+        return;
+    }
+    started = true;
+    totalTimer.start();
+    replayNext();
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEYREPLAYER_HPP
+#define KEYREPLAYER_HPP
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QVector>
+#include <QWidget>
+
+/*
+ * Replayer of the keys recorded by a KeyRecorder, measuring how long the window takes to handle every key.
+ */
+class KeyReplayer : public QObject {
+    public:
+        KeyReplayer(QString const& path, QWidget* replayedWindow, QObject* parent = nullptr);
+
+        KeyReplayer(KeyReplayer const&) = delete;
+
+        KeyReplayer& operator=(KeyReplayer const&) = delete;
+
+        /*
+         * Callback called when every key has been replayed.
+         */
+        std::function<void()> finished;
+
+        /*
+         * Get the latency of every key and the total time of the replay.
+         */
+        QString report() const;
+
+        /*
+         * Start replaying the keys with their recorded delays (does nothing if already started).
+         */
+        void start();
+
+    private:
+        struct RecordedKey {
+            int delay;
+            int key;
+            Qt::KeyboardModifiers modifiers;
+            QString text;
+        };
+
+        int index = 0;
+        QVector<RecordedKey> keys;
+        QVector<qint64> latencies;
+        bool started = false;
+        QElapsedTimer totalTimer;
+        QWidget* window;
+
+        /*
+         * Load the keys from the file.
+         */
+        void load(QString const& path);
+
+        /*
+         * Send the key to the focused widget and measure the time until the event loop is idle.
+         */
+        void replay(RecordedKey const& recordedKey);
+
+        /*
+         * Wait for the delay of the next key and replay it.
+         */
+        void replayNext();
+};
+
+#endif
@@ -16,21 +16,16 @@
  */
 
 #include <QKeyEvent>
-#include <QWebHitTestResult>
 
 #include "ModalWebView.hpp"
 #include "Window.hpp"
 
-ModalWebView::ModalWebView(Mode& initialMode, Window* initialParent) : lastClickPosition(), mode(initialMode), parent(initialParent) {
+ModalWebView::ModalWebView(Mode& initialMode, WebPage* initialPage, FrameTimer& initialFrameTimer, Window* initialParent) : frameTimer(initialFrameTimer), mode(initialMode), parent(initialParent), webPage(initialPage) {
+    webPage->setParent(this);
+    setPage(webPage);
     hideScrollbar();
 }
 
-QWebView* ModalWebView::createWindow(QWebPage::WebWindowType) {
-    QWebHitTestResult result{page()->mainFrame()->hitTestContent(lastClickPosition)};
-    parent->openNewWindow(result.linkUrl());
-    return nullptr;
-}
-
 void ModalWebView::hideScrollbar() {
     /*
      * Base64-encoded of the following CSS:
@@ -42,6 +37,7 @@ void ModalWebView::hideScrollbar() {
 }
 
 void ModalWebView::keyPressEvent(QKeyEvent* keyEvent) {
+    frameTimer.input();
     if(Mode::INSERT == mode) {
         QWebView::keyPressEvent(keyEvent);
 
@@ -55,6 +51,21 @@ void ModalWebView::keyPressEvent(QKeyEvent* keyEvent) {
 }
 
 void ModalWebView::mousePressEvent(QMouseEvent* mouseEvent) {
-    lastClickPosition = mouseEvent->pos();
+    webPage->setLastClickPosition(mouseEvent->pos());
     QWebView::mousePressEvent(mouseEvent);
 }
+
+void ModalWebView::paintEvent(QPaintEvent* paintEvent) {
+    frameTimer.start();
+    QWebView::paintEvent(paintEvent);
+    frameTimer.stop();
+}
+
+void ModalWebView::setWebPage(WebPage* newPage) {
+    //The view would delete its previous page if it was still one of its children.
+    webPage->setParent(nullptr);
+    webPage = newPage;
+    webPage->setParent(this);
+    setPage(webPage);
+    hideScrollbar();
+}
@@ -20,6 +20,9 @@
 
 #include <QWebView>
 
+#include "FrameTimer.hpp"
+#include "WebPage.hpp"
+
 enum class Mode {
     COMMAND,
     FOLLOW,
@@ -31,23 +34,30 @@ class Window;
 
 class ModalWebView : public QWebView {
     public:
-        ModalWebView(Mode& initialMode, Window* initialParent);
+        ModalWebView(Mode& initialMode, WebPage* initialPage, FrameTimer& initialFrameTimer, Window* initialParent);
 
         ModalWebView(ModalWebView const&) = delete;
 
         ModalWebView& operator=(ModalWebView const&) = delete;
 
-    protected:
-        virtual QWebView* createWindow(QWebPage::WebWindowType);
+        /*
+         * Show another page, which becomes a child of the view.
+         * The previous page is not deleted.
+         */
+        void setWebPage(WebPage* newPage);
 
+    protected:
         virtual void keyPressEvent(QKeyEvent* keyEvent);
 
         virtual void mousePressEvent(QMouseEvent* event);
 
+        virtual void paintEvent(QPaintEvent* event);
+
     private:
-        QPoint lastClickPosition;
+        FrameTimer& frameTimer;
         Mode& mode;
         Window* parent;
+        WebPage* webPage;
 
         /*
          * Hide the body scrollbar.
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QFileInfo>
+#include <QNetworkReply>
+#include <QWebFrame>
+#include <QWebPage>
+
+#include "ArchiveReply.hpp"
+#include "DownscaledImageReply.hpp"
+#include "NetworkAccessManager.hpp"
+
+NetworkAccessManager::NetworkAccessManager(SiteProfiles const& profiles, QObject* parent) : QNetworkAccessManager(parent), maximumImageSize(), siteProfiles(profiles), statistics() {
+    connect(this, &QNetworkAccessManager::finished, this, &NetworkAccessManager::requestFinished);
+}
+
+QNetworkReply* NetworkAccessManager::blockedReply(Operation operation, QIODevice* outgoingData) {
+    //A request without URL fails with an unknown protocol error.
+    return QNetworkAccessManager::createRequest(operation, QNetworkRequest(QUrl()), outgoingData);
+}
+
+QNetworkReply* NetworkAccessManager::createRequest(Operation operation, QNetworkRequest const& request, QIODevice* outgoingData) {
+    if(nullptr != archive and GetOperation == operation and archive->contains(request.url())) {
+        QByteArray contentType;
+        QByteArray content{archive->read(request.url(), contentType)};
+        return new ArchiveReply(request, contentType, content, this);
+    }
+    if(isWebFont(request) and not siteProfiles.webFontsEnabled(pageHost(request))) {
+        return blockedReply(operation, outgoingData);
+    }
+
+    //Qt does not expose the size of its connection pool (6 connections per host), but the protocols can be chosen per request.
+    QNetworkRequest networkRequest{request};
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    networkRequest.setAttribute(QNetworkRequest::HTTP2AllowedAttribute, http2Enabled);
+#endif
+    networkRequest.setAttribute(QNetworkRequest::HttpPipeliningAllowedAttribute, pipeliningEnabled);
+
+    QString host{request.url().host()};
+    if(not host.isEmpty()) {
+        HostStatistics& hostStatistics{statistics[host]};
+        hostStatistics.requests++;
+        hostStatistics.activeRequests++;
+        hostStatistics.maximumActiveRequests = std::max(hostStatistics.maximumActiveRequests, hostStatistics.activeRequests);
+        networkRequest.setAttribute(COUNTED_ATTRIBUTE, true);
+    }
+    QNetworkReply* reply{QNetworkAccessManager::createRequest(operation, networkRequest, outgoingData)};
+
+    //WebKit decodes the images at their full size, even when they are shown as thumbnails.
+    if(maximumImageSize.isValid() and GetOperation == operation and request.rawHeader("Accept").startsWith("image/")) {
+        return new DownscaledImageReply(reply, maximumImageSize, this);
+    }
+    return reply;
+}
+
+bool NetworkAccessManager::isWebFont(QNetworkRequest const& request) const {
+    static QStringList const FONT_SUFFIXES{"eot", "otf", "ttf", "woff", "woff2"};
+    return FONT_SUFFIXES.contains(QFileInfo(request.url().path()).suffix().toLower());
+}
+
+QString NetworkAccessManager::report() const {
+    static int const CONNECTIONS_PER_HOST{6};
+    QStringList hosts;
+    for(auto it(statistics.begin()) ; it != statistics.end() ; it++) {
+        //The connections are not visible, so their number is estimated from the concurrent requests.
+        int connections{it->http2Requests > 0 ? 1 : std::min(it->maximumActiveRequests, CONNECTIONS_PER_HOST)};
+        hosts.append(QString("%1: %2 requests, ~%3 reused, %4 HTTP/2, %5 pipelined").arg(it.key()).arg(it->requests).arg(it->requests - connections).arg(it->http2Requests).arg(it->pipelinedRequests));
+    }
+    return hosts.join(" | ");
+}
+
+void NetworkAccessManager::setArchive(Archive const* newArchive) {
+    archive = newArchive;
+}
+
+void NetworkAccessManager::setHttp2Enabled(bool enabled) {
+    http2Enabled = enabled;
+}
+
+void NetworkAccessManager::setMaximumImageSize(QSize const& size) {
+    maximumImageSize = size;
+}
+
+void NetworkAccessManager::setPipeliningEnabled(bool enabled) {
+    pipeliningEnabled = enabled;
+}
+
+QString NetworkAccessManager::pageHost(QNetworkRequest const& request) const {
+    QWebFrame* frame{qobject_cast<QWebFrame*>(request.originatingObject())};
+    if(nullptr == frame) {
+        return QString();
+    }
+    return frame->page()->mainFrame()->url().host();
+}
+
+void NetworkAccessManager::requestFinished(QNetworkReply* reply) {
+    //The archived and blocked replies were not counted, and a redirected reply was counted for the host first requested.
+    auto it(statistics.find(reply->request().url().host()));
+    if(not reply->request().attribute(COUNTED_ATTRIBUTE).toBool() or it == statistics.end() or 0 == it->activeRequests) {
+        return;
+    }
+
+    it->activeRequests--;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+    if(reply->attribute(QNetworkRequest::HTTP2WasUsedAttribute).toBool()) {
+        it->http2Requests++;
+    }
+#endif
+    if(reply->attribute(QNetworkRequest::HttpPipeliningWasUsedAttribute).toBool()) {
+        it->pipelinedRequests++;
+    }
+}
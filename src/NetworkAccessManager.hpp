@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETWORKACCESSMANAGER_HPP
+#define NETWORKACCESSMANAGER_HPP
+
+#include <QMap>
+#include <QNetworkAccessManager>
+#include <QSize>
+
+#include "Archive.hpp"
+#include "SiteProfiles.hpp"
+
+/*
+ * Connection statistics of a host.
+ */
+struct HostStatistics {
+    int activeRequests = 0;
+    int http2Requests = 0;
+    int maximumActiveRequests = 0;
+    int pipelinedRequests = 0;
+    int requests = 0;
+};
+
+/*
+ * Network access manager shared by the web pages of a window.
+ */
+class NetworkAccessManager : public QNetworkAccessManager {
+    public:
+        NetworkAccessManager(SiteProfiles const& profiles, QObject* parent = nullptr);
+
+        NetworkAccessManager(NetworkAccessManager const&) = delete;
+
+        NetworkAccessManager& operator=(NetworkAccessManager const&) = delete;
+
+        /*
+         * Get the connection reuse statistics of every host.
+         */
+        QString report() const;
+
+        /*
+         * Serve the resources of the archive instead of requesting them (nullptr to stop).
+         */
+        void setArchive(Archive const* newArchive);
+
+        /*
+         * Allow the requests to use HTTP/2 when the server supports it.
+         */
+        void setHttp2Enabled(bool enabled);
+
+        /*
+         * Downscale the images larger than the size (an invalid size disables the downscaling).
+         */
+        void setMaximumImageSize(QSize const& size);
+
+        /*
+         * Allow the HTTP/1.1 requests to be pipelined.
+         */
+        void setPipeliningEnabled(bool enabled);
+
+    protected:
+        virtual QNetworkReply* createRequest(Operation operation, QNetworkRequest const& request, QIODevice* outgoingData);
+
+    private:
+        /*
+         * Attribute marking the requests counted in the statistics of their host.
+         */
+        static QNetworkRequest::Attribute const COUNTED_ATTRIBUTE = QNetworkRequest::Attribute(QNetworkRequest::User + 1);
+
+        Archive const* archive = nullptr;
+        bool http2Enabled = true;
+        QSize maximumImageSize;
+        bool pipeliningEnabled = false;
+        SiteProfiles const& siteProfiles;
+        QMap<QString, HostStatistics> statistics;
+
+        /*
+         * Create a reply failing immediately.
+         */
+        QNetworkReply* blockedReply(Operation operation, QIODevice* outgoingData);
+
+
+        /*
+         * Check if the request is for a web font.
+         */
+        bool isWebFont(QNetworkRequest const& request) const;
+
+        /*
+         * Get the host of the page which sent the request.
+         */
+        QString pageHost(QNetworkRequest const& request) const;
+
+        /*
+         * Update the statistics of the host when its request is finished.
+         */
+        void requestFinished(QNetworkReply* reply);
+};
+
+#endif
@@ -0,0 +1,354 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QSet>
+
+#include "IndexSegmentWriter.hpp"
+#include "PageIndex.hpp"
+
+PageIndex::PageIndex(QString const& path) : condition(), directory(path), mutex(), pending(), queue(), segments(), worker() {
+    QDir().mkpath(directory);
+    worker = std::thread(&PageIndex::run, this);
+}
+
+PageIndex::~PageIndex() {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    condition.notify_all();
+    worker.join();
+}
+
+void PageIndex::add(QUrl const& url, QString const& title, QString const& text) {
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        queue.push_back({url.toString(), title, text});
+    }
+    condition.notify_one();
+}
+
+quint64 PageIndex::appendDocument(Page const& page) {
+    QLockFile lock{directory + "/documents.lock"};
+    lock.lock();
+
+    QFile file{directory + "/documents"};
+    if(not file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return 0;
+    }
+    quint64 offset{quint64(file.size())};
+    QString title{page.title.simplified().replace('\t', ' ')};
+    file.write(QString(page.url + '\t' + title + '\n').toUtf8());
+    return offset;
+}
+
+void PageIndex::flush() {
+    if(pending.isEmpty()) {
+        return;
+    }
+
+    QString name{QString("%1-%2.segment").arg(QDateTime::currentMSecsSinceEpoch()).arg(QCoreApplication::applicationPid())};
+    IndexSegmentWriter writer{directory + "/" + name};
+    for(auto it(pending.begin()) ; it != pending.end() ; it++) {
+        writer.add(it.key(), it.value());
+    }
+    if(not writer.commit()) {
+        qWarning("Cannot write the index segment %s", qPrintable(name));
+    }
+    pending.clear();
+    pendingDocuments = 0;
+
+    while(merge()) {
+    }
+}
+
+void PageIndex::index(Page const& page) {
+    quint64 document{appendDocument(page)};
+
+    QHash<QByteArray, quint32> frequencies;
+    for(QByteArray const& word : tokenize(page.title + ' ' + page.text)) {
+        frequencies[word]++;
+    }
+    for(auto it(frequencies.begin()) ; it != frequencies.end() ; it++) {
+        pending[it.key()].append({document, it.value()});
+    }
+    pendingDocuments++;
+}
+
+bool PageIndex::merge() {
+    QLockFile lock{directory + "/merge.lock"};
+    if(not lock.tryLock(0)) {
+        return false;
+    }
+
+    QMap<int, QStringList> tiers;
+    for(QString const& name : segmentNames()) {
+        int tier{0};
+        for(qint64 size{QFileInfo(directory + "/" + name).size() / TIER_SIZE} ; size > 0 ; size /= MERGE_FACTOR) {
+            tier++;
+        }
+        tiers[tier].append(name);
+    }
+    QStringList names;
+    for(QStringList const& tier : tiers) {
+        if(tier.size() >= MERGE_FACTOR) {
+            names = tier;
+            break;
+        }
+    }
+    if(names.isEmpty()) {
+        return false;
+    }
+
+    std::vector<std::unique_ptr<IndexSegment>> opened;
+    for(QString const& name : names) {
+        opened.emplace_back(new IndexSegment(directory + "/" + name));
+    }
+    std::vector<quint32> cursors(opened.size(), 0);
+
+    //The documents are read after the segments were written: a document they use which is not the latest was replaced.
+    QHash<QString, quint64> latest;
+    qint64 scanned{readLatestDocuments(latest, 0)};
+    QSet<quint64> live;
+    for(quint64 document : latest) {
+        live.insert(document);
+    }
+
+    //Merge the sorted term lists of the segments.
+    QString name{QString("%1-%2.segment").arg(QDateTime::currentMSecsSinceEpoch()).arg(QCoreApplication::applicationPid())};
+    IndexSegmentWriter writer{directory + "/" + name};
+    while(true) {
+        QByteArray smallest;
+        bool found{false};
+        for(size_t i{0} ; i < opened.size() ; i++) {
+            if(opened[i]->isValid() and cursors[i] < opened[i]->termCount()) {
+                QByteArray term{opened[i]->term(cursors[i])};
+                if(not found or term < smallest) {
+                    smallest = term;
+                    found = true;
+                }
+            }
+        }
+        if(not found) {
+            break;
+        }
+
+        IndexSegment::Postings postings;
+        for(size_t i{0} ; i < opened.size() ; i++) {
+            if(opened[i]->isValid() and cursors[i] < opened[i]->termCount() and opened[i]->term(cursors[i]) == smallest) {
+                for(IndexSegment::Posting const& posting : opened[i]->postings(cursors[i])) {
+                    if(live.contains(posting.first) or posting.first >= quint64(scanned)) {
+                        postings.append(posting);
+                    }
+                }
+                cursors[i]++;
+            }
+        }
+        if(not postings.isEmpty()) {
+            std::sort(postings.begin(), postings.end());
+            writer.add(smallest, postings);
+        }
+    }
+
+    if(not writer.commit()) {
+        qWarning("Cannot write the index segment %s", qPrintable(name));
+        return false;
+    }
+    for(QString const& oldName : names) {
+        QFile::remove(directory + "/" + oldName);
+    }
+    return true;
+}
+
+qint64 PageIndex::readLatestDocuments(QHash<QString, quint64>& latest, qint64 from) const {
+    QFile file{directory + "/documents"};
+    if(not file.open(QIODevice::ReadOnly) or not file.seek(from)) {
+        return from;
+    }
+
+    //The documents are only appended: a line without its end is still being written.
+    qint64 position{from};
+    QByteArray line{file.readLine()};
+    while(line.endsWith('\n')) {
+        int tab{line.indexOf('\t')};
+        if(-1 != tab) {
+            latest[QString::fromUtf8(line.constData(), tab)] = quint64(position);
+        }
+        position += line.size();
+        line = file.readLine();
+    }
+    return position;
+}
+
+void PageIndex::run() {
+    std::unique_lock<std::mutex> lock{mutex};
+    while(true) {
+        if(queue.empty()) {
+            if(stopping) {
+                break;
+            }
+            bool woken{condition.wait_for(lock, std::chrono::seconds(FLUSH_DELAY), [this]() {
+                return stopping or not queue.empty();
+            })};
+            if(not woken) {
+                lock.unlock();
+                flush();
+                lock.lock();
+            }
+            continue;
+        }
+
+        Page page{queue.front()};
+        queue.pop_front();
+        lock.unlock();
+        index(page);
+        if(pendingDocuments >= FLUSH_DOCUMENTS) {
+            flush();
+        }
+        lock.lock();
+    }
+    lock.unlock();
+    flush();
+}
+
+QList<PageIndex::Result> PageIndex::search(QString const& query, int maxResults) {
+    QList<Result> results;
+    QList<QByteArray> words{tokenize(query)};
+    if(words.isEmpty()) {
+        return results;
+    }
+
+    //Keep the segments mapped between the queries.
+    QStringList names{segmentNames()};
+    for(auto it(segments.begin()) ; it != segments.end() ; ) {
+        if(names.contains(it.key())) {
+            it++;
+        }
+        else {
+            it = segments.erase(it);
+        }
+    }
+    for(QString const& name : names) {
+        if(not segments.contains(name)) {
+            QSharedPointer<IndexSegment> segment{new IndexSegment(directory + "/" + name)};
+            if(segment->isValid()) {
+                segments[name] = segment;
+            }
+        }
+    }
+
+    QHash<quint64, double> scores;
+    for(QSharedPointer<IndexSegment> const& segment : segments) {
+        //Number of words matched so far and score of each document.
+        QHash<quint64, QPair<int, double>> matches;
+        for(int i{0} ; i < words.size() ; i++) {
+            QPair<quint32, quint32> range{segment->find(words[i], i == words.size() - 1)};
+            QHash<quint64, quint32> frequencies;
+            for(quint32 entry{range.first} ; entry < range.second ; entry++) {
+                for(IndexSegment::Posting const& posting : segment->postings(entry)) {
+                    frequencies[posting.first] += posting.second;
+                }
+            }
+            for(auto it(frequencies.begin()) ; it != frequencies.end() ; it++) {
+                QPair<int, double>& match = matches[it.key()];
+                if(match.first == i) {
+                    match.first++;
+                    match.second += 1.0 + std::log(double(it.value()));
+                }
+            }
+        }
+        for(auto it(matches.begin()) ; it != matches.end() ; it++) {
+            if(it->first == words.size()) {
+                scores[it.key()] = it->second;
+            }
+        }
+    }
+
+    //The best documents first, the most recent ones for the same score.
+    std::vector<std::pair<double, quint64>> ranking;
+    for(auto it(scores.begin()) ; it != scores.end() ; it++) {
+        ranking.push_back({it.value(), it.key()});
+    }
+    std::sort(ranking.begin(), ranking.end(), std::greater<std::pair<double, quint64>>());
+
+    //A page indexed again replaces its previous document.
+    scannedDocuments = readLatestDocuments(latestDocuments, scannedDocuments);
+
+    QFile file{directory + "/documents"};
+    if(not file.open(QIODevice::ReadOnly)) {
+        return results;
+    }
+    qint64 size{file.size()};
+    char const* data{reinterpret_cast<char const*>(file.map(0, size))};
+    if(nullptr == data) {
+        return results;
+    }
+
+    QSet<QString> urls;
+    for(auto const& item : ranking) {
+        quint64 document{item.second};
+        if(results.size() >= maxResults) {
+            break;
+        }
+        if(document >= quint64(size)) {
+            continue;
+        }
+        void const* end{std::memchr(data + document, '\n', size_t(size - qint64(document)))};
+        qint64 length{nullptr == end ? size - qint64(document) : static_cast<char const*>(end) - (data + document)};
+        QStringList fields{QString::fromUtf8(data + document, int(length)).split('\t')};
+        if(2 == fields.size() and latestDocuments.value(fields[0], document) <= document and not urls.contains(fields[0])) {
+            urls.insert(fields[0]);
+            results.append({fields[0], fields[1]});
+        }
+    }
+    return results;
+}
+
+QStringList PageIndex::segmentNames() const {
+    //A QDir is not shared: this is called from the worker and from the GUI thread.
+    return QDir(directory).entryList({"*.segment"}, QDir::Files, QDir::Name);
+}
+
+QList<QByteArray> PageIndex::tokenize(QString const& text) {
+    QList<QByteArray> words;
+    QString word;
+    for(int i{0} ; i <= text.size() ; i++) {
+        if(i < text.size() and text[i].isLetterOrNumber()) {
+            word.append(text[i].toLower());
+        }
+        else {
+            if(word.size() >= 2 and word.size() <= MAX_TERM_LENGTH) {
+                words.append(word.toUtf8());
+            }
+            word.clear();
+        }
+    }
+    return words;
+}
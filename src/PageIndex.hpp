@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PAGEINDEX_HPP
+#define PAGEINDEX_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <QDir>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSharedPointer>
+#include <QUrl>
+
+#include "IndexSegment.hpp"
+
+/*
+ * On-disk inverted index of the text of the visited pages.
+ * The pages are indexed by a background thread in new segments, merged when there are too many of them, so that
+ * several windows can update the index at the same time.
+ * The documents are appended to a file and identified by their offset in it.
+ */
+class PageIndex {
+    public:
+        struct Result {
+            QString url;
+            QString title;
+        };
+
+        PageIndex(QString const& path);
+
+        PageIndex(PageIndex const&) = delete;
+
+        PageIndex& operator=(PageIndex const&) = delete;
+
+        ~PageIndex();
+
+        /*
+         * Queue the page to be indexed in the background.
+         */
+        void add(QUrl const& url, QString const& title, QString const& text);
+
+        /*
+         * Search the pages containing every word of the query (the last one being a prefix).
+         */
+        QList<Result> search(QString const& query, int maxResults);
+
+    private:
+        struct Page {
+            QString url;
+            QString title;
+            QString text;
+        };
+
+        static int const FLUSH_DELAY = 30;
+        static int const FLUSH_DOCUMENTS = 100;
+        static int const MAX_TERM_LENGTH = 32;
+        static int const MERGE_FACTOR = 4;
+        static qint64 const TIER_SIZE = 64 * 1024;
+
+        std::condition_variable condition;
+        QString directory;
+        QHash<QString, quint64> latestDocuments;
+        std::mutex mutex;
+        QMap<QByteArray, IndexSegment::Postings> pending;
+        int pendingDocuments = 0;
+        std::deque<Page> queue;
+        qint64 scannedDocuments = 0;
+        QHash<QString, QSharedPointer<IndexSegment>> segments;
+        bool stopping = false;
+        std::thread worker;
+
+        /*
+         * Append the document to the document file and return its identifier.
+         */
+        quint64 appendDocument(Page const& page);
+
+        /*
+         * Write the pending postings in a new segment.
+         */
+        void flush();
+
+        /*
+         * Add the page to the pending postings.
+         */
+        void index(Page const& page);
+
+        /*
+         * Merge the segments of the smallest size tier holding MERGE_FACTOR segments, and return false if there is none.
+         * The tiers grow by MERGE_FACTOR from TIER_SIZE, so that a segment is rewritten once per tier.
+         * The postings of the documents replaced by a newer one of the same URL are dropped.
+         */
+        bool merge();
+
+        /*
+         * Read the documents written from the offset to keep the latest one of each URL, and return where to continue.
+         */
+        qint64 readLatestDocuments(QHash<QString, quint64>& latest, qint64 from) const;
+
+        /*
+         * Index the queued pages until stopped.
+         */
+        void run();
+
+        /*
+         * Get the file names of the segments.
+         */
+        QStringList segmentNames() const;
+
+        /*
+         * Split the text into lowercase words.
+         */
+        static QList<QByteArray> tokenize(QString const& text);
+};
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QDataStream>
+#include <QWebElementCollection>
+#include <QWebHistory>
+
+#include "Prerenderer.hpp"
+#include "ResourceMonitor.hpp"
+
+Prerenderer::Prerenderer(std::function<WebPage*()> const& initialCreatePage, qint64 initialBudget, QObject* parent) : QObject(parent), budget(initialBudget), createPage(initialCreatePage), url() {
+}
+
+void Prerenderer::cancel() {
+    if(nullptr != page) {
+        if(loaded) {
+            wasted++;
+        }
+        disconnect(page, nullptr, this, nullptr);
+        //The page may be emitting the signal which cancels it.
+        page->deleteLater();
+        page = nullptr;
+    }
+    loaded = false;
+}
+
+QUrl Prerenderer::nextPageLink(QWebFrame* frame, QWebElement const& link) {
+    static QStringList const LABELS{">", ">>", "›", "»", "next", "next ›", "next »", "next page", "older", "older posts", "page suivante", "suivant", "suivante", "suivant ›", "suivant »"};
+    QString label{link.toPlainText().simplified().toLower()};
+    if(label.isEmpty()) {
+        label = link.attribute("aria-label").simplified().toLower();
+    }
+    if(LABELS.contains(label)) {
+        QUrl result{frame->baseUrl().resolved(QUrl(link.attribute("href")))};
+        if(("http" == result.scheme() or "https" == result.scheme()) and result != frame->url()) {
+            return result;
+        }
+    }
+    return QUrl();
+}
+
+QUrl Prerenderer::nextURL() const {
+    return url;
+}
+
+void Prerenderer::prerender(QWebPage* currentPage, QUrl const& next) {
+    if(nullptr != page and next == url) {
+        return;
+    }
+
+    cancel();
+    url = next;
+    if(url.isEmpty()) {
+        return;
+    }
+
+    startMemory = ResourceMonitor::residentMemory();
+    if(startMemory > budget) {
+        overBudget++;
+        return;
+    }
+
+    page = createPage();
+    page->setParent(this);
+    page->setVisibilityState(QWebPage::VisibilityStatePrerender);
+    page->setViewportSize(currentPage->viewportSize());
+
+    //The history is copied so that going back from the next page works: a prerendered page does not load its current
+    //item, only the next page.
+    QByteArray history;
+    QDataStream output{&history, QIODevice::WriteOnly};
+    output << *currentPage->history();
+    QDataStream input{history};
+    input >> *page->history();
+    page->mainFrame()->load(url);
+
+    connect(page, &QWebPage::loadFinished, this, [this](bool success) {
+        qint64 memory{ResourceMonitor::residentMemory()};
+        if(not success) {
+            cancel();
+            return;
+        }
+        if(memory > budget) {
+            overBudget++;
+            cancel();
+            return;
+        }
+        if(not loaded) {
+            loaded = true;
+            prerendered++;
+            totalCost += std::max<qint64>(0, memory - startMemory);
+        }
+    });
+}
+
+std::function<bool()> Prerenderer::prerenderTask(QWebPage* currentPage) {
+    QWebElementCollection links;
+    int index{-1};
+    return [this, currentPage, links, index]() mutable {
+        QWebFrame* frame{currentPage->mainFrame()};
+        //A link marked as the next page is used first, otherwise the first link with a usual label of the next page.
+        if(-1 == index) {
+            QWebElement link{frame->findFirstElement("link[rel~=next][href], a[rel~=next][href]")};
+            if(not link.isNull()) {
+                prerender(currentPage, frame->baseUrl().resolved(QUrl(link.attribute("href"))));
+                return true;
+            }
+            links = frame->findAllElements("a[href]");
+            index = 0;
+            return false;
+        }
+
+        for(int end{std::min(index + LINKS_PER_STEP, links.count())} ; index < end ; index++) {
+            QUrl next{nextPageLink(frame, links.at(index))};
+            if(not next.isEmpty()) {
+                prerender(currentPage, next);
+                return true;
+            }
+        }
+        if(index < links.count()) {
+            return false;
+        }
+        prerender(currentPage, QUrl());
+        return true;
+    };
+}
+
+QString Prerenderer::report() const {
+    int requests{hits + misses};
+    return tr("Prerendering: %1/%2 hits (%3%), %4 wasted, %5 over budget, %6 MiB per page")
+        .arg(hits)
+        .arg(requests)
+        .arg(requests > 0 ? 100 * hits / requests : 0)
+        .arg(wasted)
+        .arg(overBudget)
+        .arg(double(totalCost) / std::max(1, prerendered) / (1024 * 1024), 0, 'f', 1);
+}
+
+WebPage* Prerenderer::take() {
+    if(nullptr == page or not loaded) {
+        misses++;
+        cancel();
+        return nullptr;
+    }
+
+    hits++;
+    disconnect(page, nullptr, this, nullptr);
+    page->setParent(nullptr);
+    WebPage* result{page};
+    page = nullptr;
+    loaded = false;
+    url.clear();
+    return result;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRERENDERER_HPP
+#define PRERENDERER_HPP
+
+#include <functional>
+
+#include <QUrl>
+#include <QWebElement>
+#include <QWebFrame>
+
+#include "WebPage.hpp"
+
+/*
+ * Prerender the next page of a paginated document in a hidden page, which can then replace the current page.
+ * Nothing is prerendered when the memory used by the process exceeds the budget.
+ */
+class Prerenderer : public QObject {
+    public:
+        Prerenderer(std::function<WebPage*()> const& initialCreatePage, qint64 initialBudget, QObject* parent = nullptr);
+
+        Prerenderer(Prerenderer const&) = delete;
+
+        Prerenderer& operator=(Prerenderer const&) = delete;
+
+        /*
+         * Get the URL of the next page of the last page given to prerender().
+         */
+        QUrl nextURL() const;
+
+        /*
+         * Get a task finding the next page of the current page, a few links per step, and then prerendering it.
+         * A step returns true once the task is done.
+         */
+        std::function<bool()> prerenderTask(QWebPage* currentPage);
+
+        /*
+         * Get the hit rate and the memory cost of the prerendering.
+         */
+        QString report() const;
+
+        /*
+         * Take the prerendered page if it is loaded (the caller owns it), otherwise cancel the prerendering and
+         * return nullptr.
+         */
+        WebPage* take();
+
+    private:
+        static int const LINKS_PER_STEP = 100;
+
+        qint64 budget;
+        std::function<WebPage*()> createPage;
+        int hits = 0;
+        bool loaded = false;
+        int misses = 0;
+        int overBudget = 0;
+        WebPage* page = nullptr;
+        int prerendered = 0;
+        qint64 startMemory = 0;
+        qint64 totalCost = 0;
+        QUrl url;
+        int wasted = 0;
+
+        /*
+         * Delete the page being prerendered.
+         */
+        void cancel();
+
+        /*
+         * Get the URL of the link if its label is a usual one of the next page.
+         */
+        static QUrl nextPageLink(QWebFrame* frame, QWebElement const& link);
+
+        /*
+         * Start prerendering the next page of the current page.
+         */
+        void prerender(QWebPage* currentPage, QUrl const& next);
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <unistd.h>
+
+#include <QFile>
+
+#include "ResourceMonitor.hpp"
+
+ResourceMonitor::ResourceMonitor(QNetworkDiskCache* diskCache, qint64 initialMemoryThreshold, int initialCpuThreshold, QWidget* parent) : QLabel(parent), cache(diskCache), cpuThreshold(initialCpuThreshold), memoryThreshold(initialMemoryThreshold), sampleTimer(), timer() {
+    previousCpuTime = cpuTime();
+    sampleTimer.start();
+    connect(&timer, &QTimer::timeout, this, &ResourceMonitor::sample);
+    timer.start(INTERVAL);
+}
+
+qint64 ResourceMonitor::cpuTime() {
+    //The fields following the command name, which can contain spaces, start at the third field of stat: utime and
+    //stime are the 14th and 15th fields.
+    QFile file{"/proc/self/stat"};
+    if(not file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QByteArray stat{file.readAll()};
+    QList<QByteArray> fields{stat.mid(stat.lastIndexOf(')') + 2).split(' ')};
+    return fields.size() > 12 ? fields[11].toLongLong() + fields[12].toLongLong() : 0;
+}
+
+qint64 ResourceMonitor::residentMemory() {
+    //The second field of statm is the number of resident pages.
+    QFile file{"/proc/self/statm"};
+    if(not file.open(QIODevice::ReadOnly)) {
+        return 0;
+    }
+    QList<QByteArray> fields{file.readAll().split(' ')};
+    return fields.size() > 1 ? fields[1].toLongLong() * sysconf(_SC_PAGESIZE) : 0;
+}
+
+void ResourceMonitor::sample() {
+    qint64 memory{residentMemory()};
+    qint64 time{cpuTime()};
+    qint64 elapsed{sampleTimer.restart()};
+    int cpu{elapsed > 0 ? int((time - previousCpuTime) * 1000 * 100 / (sysconf(_SC_CLK_TCK) * elapsed)) : 0};
+    previousCpuTime = time;
+
+    //The JavaScript heap and the memory caches of WebKit are not exposed by QtWebKit.
+    QString text{tr("RSS %1 MiB CPU %2%").arg(memory / (1024 * 1024)).arg(cpu)};
+    if(nullptr != cache) {
+        text += " " + tr("cache %1 MiB").arg(cache->cacheSize() / (1024 * 1024));
+    }
+    setText(text);
+
+    bool exceeded{memory > memoryThreshold or cpu > cpuThreshold};
+    setStyleSheet(exceeded ? "QLabel { color: white; background-color: red; }" : "");
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCEMONITOR_HPP
+#define RESOURCEMONITOR_HPP
+
+#include <QElapsedTimer>
+#include <QLabel>
+#include <QNetworkDiskCache>
+#include <QTimer>
+
+/*
+ * Status bar label showing the memory, CPU and cache usage of the window process, sampled every second.
+ * The label is highlighted when the memory or the CPU usage exceeds its threshold.
+ */
+class ResourceMonitor : public QLabel {
+    public:
+        ResourceMonitor(QNetworkDiskCache* diskCache, qint64 initialMemoryThreshold, int initialCpuThreshold, QWidget* parent = nullptr);
+
+        ResourceMonitor(ResourceMonitor const&) = delete;
+
+        ResourceMonitor& operator=(ResourceMonitor const&) = delete;
+
+        /*
+         * Get the resident memory of the process in bytes.
+         */
+        static qint64 residentMemory();
+
+    private:
+        static int const INTERVAL = 1000;
+
+        QNetworkDiskCache* cache;
+        int cpuThreshold;
+        qint64 memoryThreshold;
+        qint64 previousCpuTime = 0;
+        QElapsedTimer sampleTimer;
+        QTimer timer;
+
+        /*
+         * Get the CPU time used by the process in clock ticks.
+         */
+        static qint64 cpuTime();
+
+        /*
+         * Read the usage of the process and update the label.
+         */
+        void sample();
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+
+#include "Session.hpp"
+
+Session::Session(QString const& initialDirectory) : directory(initialDirectory), lock(), path(), runningLock() {
+}
+
+QStringList Session::allFiles() const {
+    QStringList result;
+    for(QFileInfo const& info : QDir(directory).entryInfoList({"*.session"}, QDir::Files, QDir::Time)) {
+        result << info.filePath();
+    }
+    return result;
+}
+
+void Session::clear() {
+    QLockFile directoryLock{directory + "/session.lock"};
+    directoryLock.lock();
+    for(QString const& file : files()) {
+        QFile::remove(file);
+    }
+}
+
+void Session::close() {
+    lock.reset();
+    runningLock.reset();
+}
+
+QStringList Session::files() const {
+    QStringList result;
+    for(QString const& file : allFiles()) {
+        if(file != path and not isRunning(file + ".lock")) {
+            result << file;
+        }
+    }
+    return result;
+}
+
+bool Session::hasOtherWindows() const {
+    //A window saves its session file long after it starts, but it is running from its constructor.
+    QString const ownName{QString::number(QCoreApplication::applicationPid()) + ".running"};
+    for(QString const& name : QDir(directory).entryList({"*.running"}, QDir::Files)) {
+        if(name != ownName and isRunning(directory + "/" + name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Session::isRunning(QString const& lockPath) {
+    //Only the lock of a window which is not running anymore is stale, whatever its age.
+    QLockFile fileLock{lockPath};
+    fileLock.setStaleLockTime(0);
+    return not fileLock.tryLock(0);
+}
+
+bool Session::load(QString const& sessionPath, SessionState& state) {
+    setPath(sessionPath);
+
+    QFile file{path};
+    if(not file.open(QIODevice::ReadOnly)) {
+        qWarning("Cannot read the session file %s", qPrintable(path));
+        return false;
+    }
+
+    QDataStream header{&file};
+    quint32 magic{0};
+    quint16 version{0};
+    header >> magic >> version;
+    if(MAGIC != magic or VERSION != version) {
+        qWarning("Invalid session file %s", qPrintable(path));
+        return false;
+    }
+
+    QByteArray data{qUncompress(file.readAll())};
+    QDataStream stream{data};
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream >> state.url >> state.title >> state.history >> state.scrollPosition >> state.mode;
+    return QDataStream::Ok == stream.status();
+}
+
+void Session::remove() {
+    if(not path.isEmpty()) {
+        QFile::remove(path);
+    }
+}
+
+bool Session::save(SessionState const& state) {
+    if(path.isEmpty()) {
+        QDir().mkpath(directory);
+        setPath(directory + "/" + QString::number(QDateTime::currentMSecsSinceEpoch()) + "-" + QString::number(QCoreApplication::applicationPid()) + ".session");
+    }
+
+    QByteArray data;
+    QDataStream stream{&data, QIODevice::WriteOnly};
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << state.url << state.title << state.history << state.scrollPosition << state.mode;
+
+    QSaveFile file{path};
+    if(not file.open(QIODevice::WriteOnly)) {
+        qWarning("Cannot write the session file %s", qPrintable(path));
+        return false;
+    }
+    QDataStream header{&file};
+    header << MAGIC << VERSION;
+    file.write(qCompress(data));
+    return file.commit();
+}
+
+void Session::setPath(QString const& sessionPath) {
+    path = sessionPath;
+    lock.reset(new QLockFile(path + ".lock"));
+    lock->setStaleLockTime(0);
+    if(not lock->tryLock(0)) {
+        qWarning("The session file %s is used by another window", qPrintable(path));
+    }
+}
+
+void Session::start() {
+    QDir().mkpath(directory);
+    runningLock.reset(new QLockFile(directory + "/" + QString::number(QCoreApplication::applicationPid()) + ".running"));
+    runningLock->setStaleLockTime(0);
+    if(not runningLock->tryLock(0)) {
+        qWarning("Cannot register the window in the session directory %s", qPrintable(directory));
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SESSION_HPP
+#define SESSION_HPP
+
+#include <memory>
+
+#include <QByteArray>
+#include <QLockFile>
+#include <QPoint>
+#include <QString>
+#include <QStringList>
+#include <QUrl>
+
+/*
+ * State of a window saved in its session file.
+ */
+struct SessionState {
+    QByteArray history;
+    int mode = 0;
+    QPoint scrollPosition;
+    QString title;
+    QUrl url;
+};
+
+/*
+ * Session file of a window.
+ * Every window saves its state in its own file of the session directory (they run in different processes) and
+ * holds a lock on it while running.
+ */
+class Session {
+    public:
+        Session(QString const& initialDirectory);
+
+        Session(Session const&) = delete;
+
+        Session& operator=(Session const&) = delete;
+
+        /*
+         * Remove the session files of the windows not running, to start a new session.
+         */
+        void clear();
+
+        /*
+         * Stop running: the session file can then be restored, or cleared by a new session.
+         */
+        void close();
+
+        /*
+         * Get the session files of the windows not running, the most recently saved first.
+         */
+        QStringList files() const;
+
+        /*
+         * Check if another window is running, even if it has not saved its session file yet.
+         */
+        bool hasOtherWindows() const;
+
+        /*
+         * Read the state from a session file, which becomes the file of this session.
+         */
+        bool load(QString const& sessionPath, SessionState& state);
+
+        /*
+         * Remove the session file.
+         */
+        void remove();
+
+        /*
+         * Save the state in the session file, creating it if needed.
+         * The file is replaced atomically, so a crash leaves the previous state.
+         */
+        bool save(SessionState const& state);
+
+        /*
+         * Register this window as running, before it decides anything from the other windows.
+         */
+        void start();
+
+    private:
+        static quint32 const MAGIC = 0x4e565353;
+        static quint16 const VERSION = 1;
+
+        QString directory;
+        std::unique_ptr<QLockFile> lock;
+        QString path;
+        std::unique_ptr<QLockFile> runningLock;
+
+        /*
+         * Get the session files of the directory, the most recently saved first.
+         */
+        QStringList allFiles() const;
+
+        /*
+         * Check if the window holding the lock file is running.
+         */
+        static bool isRunning(QString const& lockPath);
+
+        /*
+         * Use the session file for this window.
+         */
+        void setPath(QString const& sessionPath);
+};
+
+#endif
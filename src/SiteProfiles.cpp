@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QSettings>
+
+#include "SiteProfiles.hpp"
+
+static QMap<QString, QWebSettings::WebAttribute> const ATTRIBUTE_KEYS{
+    {"images", QWebSettings::AutoLoadImages},
+    {"javascript", QWebSettings::JavascriptEnabled},
+    {"localstorage", QWebSettings::LocalStorageEnabled},
+    {"plugins", QWebSettings::PluginsEnabled}
+};
+
+SiteProfiles::SiteProfiles(QString const& path) : profiles() {
+    load(path);
+}
+
+void SiteProfiles::apply(QString const& host, QWebSettings* settings) const {
+    for(auto attribute : ATTRIBUTE_KEYS) {
+        settings->resetAttribute(attribute);
+    }
+
+    SiteProfile const* profile{find(host)};
+    if(nullptr != profile) {
+        for(auto it(profile->attributes.begin()) ; it != profile->attributes.end() ; it++) {
+            settings->setAttribute(it.key(), it.value());
+        }
+    }
+}
+
+SiteProfile const* SiteProfiles::find(QString const& host) const {
+    QString domain{host.toLower()};
+    while(not domain.isEmpty()) {
+        auto it(profiles.find(domain));
+        if(it != profiles.end()) {
+            return &it.value();
+        }
+        int index{domain.indexOf('.')};
+        if(-1 == index) {
+            break;
+        }
+        domain.remove(0, index + 1);
+    }
+    return nullptr;
+}
+
+void SiteProfiles::load(QString const& path) {
+    QSettings file{path, QSettings::IniFormat};
+    for(QString const& host : file.childGroups()) {
+        SiteProfile profile;
+        file.beginGroup(host);
+        for(auto it(ATTRIBUTE_KEYS.begin()) ; it != ATTRIBUTE_KEYS.end() ; it++) {
+            if(file.contains(it.key())) {
+                profile.attributes[it.value()] = file.value(it.key()).toBool();
+            }
+        }
+        profile.reader = file.value("reader", false).toBool();
+        profile.scriptBudget = file.value("scriptbudget", -1).toLongLong();
+        profile.webFonts = file.value("fonts", true).toBool();
+        file.endGroup();
+        profiles[host.toLower()] = profile;
+    }
+}
+
+bool SiteProfiles::readerEnabled(QString const& host) const {
+    SiteProfile const* profile{find(host)};
+    return nullptr != profile and profile->reader;
+}
+
+qint64 SiteProfiles::scriptBudget(QString const& host, qint64 defaultBudget) const {
+    SiteProfile const* profile{find(host)};
+    return nullptr == profile or -1 == profile->scriptBudget ? defaultBudget : profile->scriptBudget;
+}
+
+bool SiteProfiles::webFontsEnabled(QString const& host) const {
+    SiteProfile const* profile{find(host)};
+    return nullptr == profile or profile->webFonts;
+}
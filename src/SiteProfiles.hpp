@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SITEPROFILES_HPP
+#define SITEPROFILES_HPP
+
+#include <QMap>
+#include <QString>
+#include <QWebSettings>
+
+/*
+ * Settings overridden for a host.
+ */
+struct SiteProfile {
+    QMap<QWebSettings::WebAttribute, bool> attributes;
+    bool reader = false;
+    qint64 scriptBudget = -1;
+    bool webFonts = true;
+};
+
+/*
+ * Per-host performance profiles loaded from an ini file where each group is a host:
+ * [intranet.example.com]
+ * javascript=false
+ * images=false
+ * plugins=false
+ * fonts=false
+ * localstorage=false
+ * reader=true
+ * scriptbudget=1000
+ * A profile also applies to the subdomains of its host.
+ */
+class SiteProfiles {
+    public:
+        SiteProfiles(QString const& path);
+
+        /*
+         * Apply the profile of the host to the settings.
+         * The attributes not overridden by the profile are reset to the global settings.
+         */
+        void apply(QString const& host, QWebSettings* settings) const;
+
+        /*
+         * Check if the pages of the host are shown in reader mode once loaded.
+         */
+        bool readerEnabled(QString const& host) const;
+
+        /*
+         * Get the CPU time budget in milliseconds of a script for the host (0 means unlimited).
+         */
+        qint64 scriptBudget(QString const& host, qint64 defaultBudget) const;
+
+        /*
+         * Check if the web fonts can be downloaded for the host.
+         */
+        bool webFontsEnabled(QString const& host) const;
+
+    private:
+        QMap<QString, SiteProfile> profiles;
+
+        /*
+         * Get the profile of the host or of its nearest parent domain.
+         */
+        SiteProfile const* find(QString const& host) const;
+
+        /*
+         * Load the profiles from the file.
+         */
+        void load(QString const& path);
+};
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StartupTrace.hpp"
+
+StartupTrace::StartupTrace() : phases(), timer() {
+    timer.start();
+}
+
+void StartupTrace::mark(QString const& phase) {
+    phases.append(qMakePair(phase, timer.nsecsElapsed()));
+}
+
+QString StartupTrace::report() const {
+    auto milliseconds = [](qint64 nanoseconds) {
+        return QString::number(double(nanoseconds) / 1e6, 'f', 1);
+    };
+
+    QString result;
+    qint64 previous{0};
+    for(auto const& phase : phases) {
+        result += QString("%1: %2 ms (at %3 ms)\n").arg(phase.first, -24).arg(milliseconds(phase.second - previous), 7).arg(milliseconds(phase.second));
+        previous = phase.second;
+    }
+    return result;
+}
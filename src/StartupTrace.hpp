@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STARTUPTRACE_HPP
+#define STARTUPTRACE_HPP
+
+#include <QElapsedTimer>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+/*
+ * Timing of the startup phases, measured from the creation of the trace.
+ */
+class StartupTrace {
+    public:
+        StartupTrace();
+
+        /*
+         * Record the end of a phase.
+         */
+        void mark(QString const& phase);
+
+        /*
+         * Get the duration of every phase and the total time.
+         */
+        QString report() const;
+
+    private:
+        QVector<QPair<QString, qint64>> phases;
+        QElapsedTimer timer;
+};
+
+#endif
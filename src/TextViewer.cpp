@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <QFontDatabase>
+#include <QKeyEvent>
+#include <QPainter>
+#include <QScrollBar>
+
+#include "TextViewer.hpp"
+#include "Window.hpp"
+
+TextViewer::TextViewer(Window* initialParent) : file(), parent(initialParent), searchedText() {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setFrameShape(QFrame::NoFrame);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+}
+
+TextViewer::~TextViewer() {
+    closeFile();
+}
+
+void TextViewer::closeFile() {
+    if(nullptr != data) {
+        file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+        data = nullptr;
+    }
+    file.close();
+    size = 0;
+    topOffset = 0;
+    horizontalOffset = 0;
+    matchOffset = -1;
+    searchedText.clear();
+}
+
+bool TextViewer::find(QString const& text, bool backward) {
+    QByteArray needle{text.toUtf8()};
+    if(needle.isEmpty() or nullptr == data) {
+        matchOffset = -1;
+        searchedText.clear();
+        viewport()->update();
+        return false;
+    }
+
+    //The same text continues after the current match while a new text (incremental search) can match at the same place.
+    qint64 from{-1 == matchOffset ? topOffset : matchOffset};
+    if(needle == searchedText and -1 != matchOffset) {
+        from += backward ? -1 : 1;
+    }
+    searchedText = needle;
+
+    qint64 offset;
+    if(backward) {
+        offset = searchBackward(needle, from);
+        if(-1 == offset) {
+            offset = searchBackward(needle, size);
+        }
+    }
+    else {
+        offset = search(needle, from, size);
+        if(-1 == offset) {
+            offset = search(needle, 0, size);
+        }
+    }
+
+    matchOffset = offset;
+    matchLength = needle.size();
+    if(-1 != offset) {
+        qint64 start{lineStart(offset)};
+        if(start < topOffset or start >= nextLine(topOffset, visibleLineCount())) {
+            setTopOffset(previousLine(start, visibleLineCount() / 2));
+        }
+    }
+    viewport()->update();
+    return -1 != offset;
+}
+
+void TextViewer::keyPressEvent(QKeyEvent* keyEvent) {
+    parent->keyPress(keyEvent);
+}
+
+qint64 TextViewer::lineEnd(qint64 offset) const {
+    qint64 length{std::min(size - offset, MAX_LINE_LENGTH)};
+    void const* newLine{std::memchr(data + offset, '\n', size_t(length))};
+    return nullptr == newLine ? offset + length : static_cast<char const*>(newLine) - data;
+}
+
+int TextViewer::lineHeight() const {
+    return fontMetrics().lineSpacing();
+}
+
+qint64 TextViewer::lineStart(qint64 offset) const {
+    void const* newLine{memrchr(data, '\n', size_t(offset))};
+    qint64 start{nullptr == newLine ? 0 : static_cast<char const*>(newLine) - data + 1};
+
+    //A wrapped line starts every MAX_LINE_LENGTH bytes, and the new line character ends the last one.
+    qint64 column{offset - start};
+    if(column > 0 and offset < size and '\n' == data[offset]) {
+        column--;
+    }
+    return start + column / MAX_LINE_LENGTH * MAX_LINE_LENGTH;
+}
+
+qint64 TextViewer::maximumTopOffset() const {
+    return previousLine(size, visibleLineCount());
+}
+
+qint64 TextViewer::nextLine(qint64 offset, qint64 count) const {
+    for(qint64 i{0} ; i < count and offset < size ; i++) {
+        qint64 end{lineEnd(offset)};
+        offset = end < size and '\n' == data[end] ? end + 1 : end;
+    }
+    return offset;
+}
+
+bool TextViewer::open(QString const& path) {
+    closeFile();
+    file.setFileName(path);
+    if(not file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    size = file.size();
+    uchar* map{file.map(0, size)};
+    if(nullptr == map) {
+        closeFile();
+        return false;
+    }
+    data = reinterpret_cast<char const*>(map);
+
+    updateScrollBar();
+    viewport()->update();
+    return true;
+}
+
+void TextViewer::paintEvent(QPaintEvent*) {
+    QPainter painter{viewport()};
+    if(nullptr == data) {
+        return;
+    }
+
+    QFontMetrics metrics{fontMetrics()};
+    int const margin{4};
+    int y{0};
+    qint64 offset{topOffset};
+    int lineCount{visibleLineCount() + 1};
+    for(int i{0} ; i < lineCount and offset < size ; i++) {
+        qint64 end{lineEnd(offset)};
+        qint64 length{end - offset};
+        QString line{QString::fromUtf8(data + offset, int(length))};
+        int x{margin - horizontalOffset};
+
+        if(-1 != matchOffset and matchOffset >= offset and matchOffset < offset + length) {
+            int matchX{metrics.width(QString::fromUtf8(data + offset, int(matchOffset - offset)))};
+            int matchWidth{metrics.width(QString::fromUtf8(data + matchOffset, int(std::min(matchLength, end - matchOffset))))};
+            painter.fillRect(x + matchX, y, matchWidth, lineHeight(), Qt::yellow);
+        }
+
+        painter.drawText(x, y + metrics.ascent(), line);
+        y += lineHeight();
+        offset = nextLine(offset, 1);
+    }
+}
+
+qint64 TextViewer::previousLine(qint64 offset, qint64 count) const {
+    for(qint64 i{0} ; i < count and offset > 0 ; i++) {
+        offset = lineStart(offset - 1);
+    }
+    return offset;
+}
+
+void TextViewer::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+    setTopOffset(topOffset);
+}
+
+void TextViewer::scrollBy(int dx, int dy) {
+    horizontalOffset = std::max(0, horizontalOffset + dx);
+
+    qint64 lines{dy / lineHeight()};
+    if(0 == lines and 0 != dy) {
+        lines = dy > 0 ? 1 : -1;
+    }
+    if(lines > 0) {
+        setTopOffset(nextLine(topOffset, lines));
+    }
+    else {
+        setTopOffset(previousLine(topOffset, -lines));
+    }
+}
+
+void TextViewer::scrollToBottom() {
+    setTopOffset(size);
+}
+
+void TextViewer::scrollToTop() {
+    setTopOffset(0);
+}
+
+qint64 TextViewer::search(QByteArray const& needle, qint64 from, qint64 to) const {
+    if(from < 0 or to - from < needle.size()) {
+        return -1;
+    }
+    //glibc vectorizes memmem() and the memchr() it uses to skip to the candidates.
+    void const* match{memmem(data + from, size_t(to - from), needle.constData(), size_t(needle.size()))};
+    return nullptr == match ? -1 : static_cast<char const*>(match) - data;
+}
+
+qint64 TextViewer::searchBackward(QByteArray const& needle, qint64 from) const {
+    qint64 limit{std::min(from + needle.size(), size)};
+    while(limit >= needle.size()) {
+        qint64 start{std::max<qint64>(0, limit - SEARCH_CHUNK_SIZE)};
+        qint64 last{-1};
+        for(qint64 offset{search(needle, start, limit)} ; -1 != offset ; offset = search(needle, offset + 1, limit)) {
+            last = offset;
+        }
+        if(-1 != last or 0 == start) {
+            return last;
+        }
+        //Overlap the chunks so that a match across their boundary is found.
+        limit = start + needle.size() - 1;
+    }
+    return -1;
+}
+
+void TextViewer::setTopOffset(qint64 offset) {
+    if(nullptr == data) {
+        return;
+    }
+    topOffset = lineStart(std::max<qint64>(0, std::min(offset, maximumTopOffset())));
+    updateScrollBar();
+    viewport()->update();
+}
+
+void TextViewer::updateScrollBar() {
+    qint64 maximum{nullptr == data ? 0 : maximumTopOffset()};
+    verticalScrollBar()->setRange(0, maximum > 0 ? SCROLL_RANGE : 0);
+    verticalScrollBar()->setValue(maximum > 0 ? int(topOffset * SCROLL_RANGE / maximum) : 0);
+}
+
+int TextViewer::visibleLineCount() const {
+    return std::max(1, viewport()->height() / lineHeight());
+}
+
+void TextViewer::wheelEvent(QWheelEvent* event) {
+    scrollBy(-event->angleDelta().x(), -event->angleDelta().y());
+}
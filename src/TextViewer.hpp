@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEXTVIEWER_HPP
+#define TEXTVIEWER_HPP
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <QFile>
+
+class Window;
+
+/*
+ * Viewer for huge text files.
+ * The file is memory-mapped and only the visible lines are laid out, so the size of the file does not matter.
+ * The position is a byte offset: no line index is built.
+ * The lines longer than MAX_LINE_LENGTH bytes are wrapped, so that laying out a line never scans the rest of the file.
+ */
+class TextViewer : public QAbstractScrollArea {
+    public:
+        TextViewer(Window* initialParent);
+
+        TextViewer(TextViewer const&) = delete;
+
+        TextViewer& operator=(TextViewer const&) = delete;
+
+        virtual ~TextViewer();
+
+        /*
+         * Close the file.
+         */
+        void closeFile();
+
+        /*
+         * Find the next (or previous if backward is true) occurrence of the text, wrapping around the file.
+         * An empty text clears the current match.
+         */
+        bool find(QString const& text, bool backward);
+
+        /*
+         * Open the file.
+         */
+        bool open(QString const& path);
+
+        /*
+         * Scroll by the specified number of pixels.
+         */
+        void scrollBy(int dx, int dy);
+
+        /*
+         * Scroll to the end of the file.
+         */
+        void scrollToBottom();
+
+        /*
+         * Scroll to the beginning of the file.
+         */
+        void scrollToTop();
+
+    protected:
+        virtual void keyPressEvent(QKeyEvent* keyEvent);
+
+        virtual void paintEvent(QPaintEvent* event);
+
+        virtual void resizeEvent(QResizeEvent* event);
+
+        virtual void wheelEvent(QWheelEvent* event);
+
+    private:
+        static qint64 const MAX_LINE_LENGTH = 4096;
+        static qint64 const SEARCH_CHUNK_SIZE = 1024 * 1024;
+        static int const SCROLL_RANGE = 10000;
+
+        char const* data = nullptr;
+        QFile file;
+        int horizontalOffset = 0;
+        qint64 matchLength = 0;
+        qint64 matchOffset = -1;
+        Window* parent;
+        QByteArray searchedText;
+        qint64 size = 0;
+        qint64 topOffset = 0;
+
+        /*
+         * Get the offset of the end of the line starting at offset, at most MAX_LINE_LENGTH bytes after it.
+         */
+        qint64 lineEnd(qint64 offset) const;
+
+        /*
+         * Get the height of a line in pixels.
+         */
+        int lineHeight() const;
+
+        /*
+         * Get the offset of the beginning of the (wrapped) line containing offset.
+         */
+        qint64 lineStart(qint64 offset) const;
+
+        /*
+         * Get the greatest offset of the first visible line.
+         */
+        qint64 maximumTopOffset() const;
+
+        /*
+         * Get the offset of the line count lines after the one starting at offset.
+         */
+        qint64 nextLine(qint64 offset, qint64 count) const;
+
+        /*
+         * Get the offset of the line count lines before the one starting at offset.
+         */
+        qint64 previousLine(qint64 offset, qint64 count) const;
+
+        /*
+         * Get the offset of the first occurrence of the needle between from and to (-1 if none).
+         */
+        qint64 search(QByteArray const& needle, qint64 from, qint64 to) const;
+
+        /*
+         * Get the offset of the last occurrence of the needle starting at or before from (-1 if none).
+         */
+        qint64 searchBackward(QByteArray const& needle, qint64 from) const;
+
+        /*
+         * Set the offset of the first visible line.
+         */
+        void setTopOffset(qint64 offset);
+
+        /*
+         * Update the scroll bar used to show the position.
+         */
+        void updateScrollBar();
+
+        /*
+         * Get the number of lines fitting in the viewport.
+         */
+        int visibleLineCount() const;
+};
+
+#endif
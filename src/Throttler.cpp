@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <ctime>
+
+#include <QWebElement>
+
+#include "Throttler.hpp"
+
+QString const Throttler::ANIMATION_STYLE_ID = "__navim_throttle__";
+
+Throttler::Throttler(QWidget* initialView, QWebPage* initialPage, int initialInterval) : QObject(initialPage), activeTime(), interval(initialInterval), page(initialPage), throttledTime(), view(initialView) {
+    activeTime.start();
+    activeStartCPUTime = processTime();
+
+    //A page can be created before its throttler, with documents already loaded, when it was prerendered.
+    watchFrame(page->mainFrame());
+    connect(page, &QWebPage::frameCreated, this, &Throttler::watchFrame);
+    //A document loaded while throttled does not have the animation style yet.
+    connect(page, &QWebPage::loadFinished, this, [this]() {
+        if(throttled) {
+            applyToFrame(page->mainFrame());
+        }
+    });
+}
+
+void Throttler::applyToFrame(QWebFrame* frame) {
+    frame->evaluateJavaScript(QString("if(window.__navimThrottle) { window.__navimThrottle.enabled = %1; }").arg(throttled ? "true" : "false"));
+
+    QWebElement style{frame->findFirstElement("#" + ANIMATION_STYLE_ID)};
+    if(throttled and style.isNull()) {
+        QWebElement head{frame->findFirstElement("head")};
+        if(not head.isNull()) {
+            head.appendInside("<style id=\"" + ANIMATION_STYLE_ID + "\">"
+                "*, *::before, *::after {"
+                    "animation-play-state: paused !important;"
+                    "-webkit-animation-play-state: paused !important;"
+                "}"
+            "</style>");
+        }
+    }
+    else if(not throttled and not style.isNull()) {
+        style.removeFromDocument();
+    }
+
+    for(QWebFrame* child : frame->childFrames()) {
+        applyToFrame(child);
+    }
+}
+
+void Throttler::installTimerWrappers(QWebFrame* frame) {
+    //While throttled, the timers are delayed to the next multiple of the interval, so that they fire together.
+    //The intervals are chains of timeouts: the delay of every run is chosen when it is scheduled.
+    frame->evaluateJavaScript(QString(R"js(
+        (function() {
+            if(window.__navimThrottle) {
+                return;
+            }
+            var throttle = window.__navimThrottle = {enabled: %1, interval: %2};
+            var setTimeout = window.setTimeout;
+            var clearTimeout = window.clearTimeout;
+            var setInterval = window.setInterval;
+            var clearInterval = window.clearInterval;
+            var intervals = {};
+            var nextInterval = 1000000000;
+            function throttledDelay(delay) {
+                delay = Math.max(Number(delay) || 0, 0);
+                if(!throttle.enabled) {
+                    return delay;
+                }
+                var now = Date.now();
+                return Math.ceil((now + delay) / throttle.interval) * throttle.interval - now;
+            }
+            window.setTimeout = function(callback, delay) {
+                var args = Array.prototype.slice.call(arguments);
+                args[1] = throttledDelay(delay);
+                return setTimeout.apply(window, args);
+            };
+            window.setInterval = function(callback, delay) {
+                if(typeof callback !== "function") {
+                    return setInterval.apply(window, arguments);
+                }
+                var args = Array.prototype.slice.call(arguments, 2);
+                var id = nextInterval++;
+                var schedule = function() {
+                    intervals[id] = setTimeout.call(window, function() {
+                        schedule();
+                        callback.apply(window, args);
+                    }, throttledDelay(delay));
+                };
+                schedule();
+                return id;
+            };
+            window.clearInterval = function(id) {
+                if(id in intervals) {
+                    clearTimeout.call(window, intervals[id]);
+                    delete intervals[id];
+                }
+                else {
+                    clearInterval.call(window, id);
+                }
+            };
+        })();
+    )js").arg(throttled ? "true" : "false").arg(interval));
+}
+
+bool Throttler::isThrottled() const {
+    return throttled;
+}
+
+qint64 Throttler::processTime() {
+    timespec time;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return qint64(time.tv_sec) * 1000 + time.tv_nsec / 1000000;
+}
+
+QString Throttler::resume() {
+    if(not throttled) {
+        return QString();
+    }
+
+    throttled = false;
+    page->setVisibilityState(QWebPage::VisibilityStateVisible);
+    applyToFrame(page->mainFrame());
+    view->setUpdatesEnabled(true);
+    view->update();
+
+    //Compare the CPU usage while throttled to the one of the previous active period.
+    qint64 duration{std::max<qint64>(1, throttledTime.elapsed())};
+    double throttledUsage{100.0 * double(processTime() - throttledStartCPUTime) / double(duration)};
+    qint64 saved{std::max<qint64>(0, qint64((activeUsage - throttledUsage) * double(duration) / 100.0))};
+
+    activeTime.start();
+    activeStartCPUTime = processTime();
+
+    return tr("Throttled for %1 s: %2% CPU instead of %3%, %4 ms saved")
+        .arg(duration / 1000)
+        .arg(throttledUsage, 0, 'f', 1)
+        .arg(activeUsage, 0, 'f', 1)
+        .arg(saved);
+}
+
+void Throttler::throttle() {
+    if(throttled) {
+        return;
+    }
+
+    activeUsage = 100.0 * double(processTime() - activeStartCPUTime) / double(std::max<qint64>(1, activeTime.elapsed()));
+    throttledTime.start();
+    throttledStartCPUTime = processTime();
+
+    throttled = true;
+    //A hidden page does not run the animation frame callbacks.
+    page->setVisibilityState(QWebPage::VisibilityStateHidden);
+    applyToFrame(page->mainFrame());
+    view->setUpdatesEnabled(false);
+}
+
+void Throttler::watchFrame(QWebFrame* frame) {
+    installTimerWrappers(frame);
+    connect(frame, &QWebFrame::javaScriptWindowObjectCleared, this, [this, frame]() {
+        installTimerWrappers(frame);
+    });
+    for(QWebFrame* child : frame->childFrames()) {
+        watchFrame(child);
+    }
+}
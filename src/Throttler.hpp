@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef THROTTLER_HPP
+#define THROTTLER_HPP
+
+#include <QElapsedTimer>
+#include <QWebFrame>
+#include <QWebPage>
+#include <QWidget>
+
+/*
+ * Throttle a page while its window is not visible or not focused: the JavaScript timers are clamped, the
+ * animations are paused and the view stops painting.
+ */
+class Throttler : public QObject {
+    public:
+        Throttler(QWidget* initialView, QWebPage* initialPage, int initialInterval);
+
+        Throttler(Throttler const&) = delete;
+
+        Throttler& operator=(Throttler const&) = delete;
+
+        /*
+         * Check if the page is throttled.
+         */
+        bool isThrottled() const;
+
+        /*
+         * Resume the page at full speed and return a report of the CPU time saved.
+         */
+        QString resume();
+
+        /*
+         * Throttle the page.
+         */
+        void throttle();
+
+    private:
+        static QString const ANIMATION_STYLE_ID;
+
+        qint64 activeStartCPUTime = 0;
+        QElapsedTimer activeTime;
+        double activeUsage = 0;
+        int interval;
+        QWebPage* page;
+        bool throttled = false;
+        qint64 throttledStartCPUTime = 0;
+        QElapsedTimer throttledTime;
+        QWidget* view;
+
+        /*
+         * Apply the throttling state to the frame and its children.
+         */
+        void applyToFrame(QWebFrame* frame);
+
+        /*
+         * Install the timer wrappers in the frame.
+         */
+        void installTimerWrappers(QWebFrame* frame);
+
+        /*
+         * Get the CPU time used by the process in milliseconds.
+         */
+        static qint64 processTime();
+
+        /*
+         * Install the timer wrappers in the current documents of the frame and its children, and in their next ones.
+         */
+        void watchFrame(QWebFrame* frame);
+};
+
+#endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QKeyEvent>
+#include <QScrollBar>
+
+#include "TiledWebView.hpp"
+#include "Window.hpp"
+
+TiledWebView::TiledWebView(Mode& initialMode, WebPage* initialPage, FrameTimer& initialFrameTimer, Window* initialParent) : frameTimer(initialFrameTimer), mode(initialMode), parent(initialParent), scene(), webItem(new QGraphicsWebView), webPage(initialPage) {
+    //The tiled backing store is only used when the item is resized to the contents.
+    webItem->setResizesToContents(true);
+    showPage();
+    scene.addItem(webItem);
+    scene.setFocusItem(webItem);
+    connect(webItem, &QGraphicsWidget::geometryChanged, this, [this]() {
+        scene.setSceneRect(webItem->boundingRect());
+    });
+
+    setScene(&scene);
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    setFrameShape(QFrame::NoFrame);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+}
+
+void TiledWebView::keyPressEvent(QKeyEvent* keyEvent) {
+    frameTimer.input();
+    if(Mode::INSERT == mode) {
+        QGraphicsView::keyPressEvent(keyEvent);
+
+        if(Qt::Key_Escape == keyEvent->key()) {
+            parent->normalMode();
+        }
+    }
+    else {
+        parent->keyPress(keyEvent);
+    }
+}
+
+void TiledWebView::mousePressEvent(QMouseEvent* mouseEvent) {
+    webPage->setLastClickPosition(mouseEvent->pos() + scrollPosition());
+    QGraphicsView::mousePressEvent(mouseEvent);
+}
+
+void TiledWebView::paintEvent(QPaintEvent* paintEvent) {
+    frameTimer.start();
+    QGraphicsView::paintEvent(paintEvent);
+    frameTimer.stop();
+}
+
+void TiledWebView::resizeEvent(QResizeEvent* resizeEvent) {
+    QGraphicsView::resizeEvent(resizeEvent);
+    //The page is laid out for the width of the view.
+    webPage->setPreferredContentsSize(viewport()->size());
+}
+
+void TiledWebView::scrollBy(int dx, int dy) {
+    horizontalScrollBar()->setValue(horizontalScrollBar()->value() + dx);
+    verticalScrollBar()->setValue(verticalScrollBar()->value() + dy);
+}
+
+QPoint TiledWebView::scrollPosition() const {
+    return QPoint(horizontalScrollBar()->value(), verticalScrollBar()->value());
+}
+
+void TiledWebView::setScrollPosition(QPoint const& position) {
+    horizontalScrollBar()->setValue(position.x());
+    verticalScrollBar()->setValue(position.y());
+}
+
+void TiledWebView::setWebPage(WebPage* newPage) {
+    webPage->setParent(nullptr);
+    webPage = newPage;
+    webPage->setPreferredContentsSize(viewport()->size());
+    showPage();
+    setScrollPosition(QPoint());
+}
+
+void TiledWebView::showPage() {
+    webPage->setParent(this);
+    webPage->settings()->setAttribute(QWebSettings::AcceleratedCompositingEnabled, true);
+    webPage->settings()->setAttribute(QWebSettings::TiledBackingStoreEnabled, true);
+    webItem->setPage(webPage);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TILEDWEBVIEW_HPP
+#define TILEDWEBVIEW_HPP
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QGraphicsWebView>
+
+#include "FrameTimer.hpp"
+#include "ModalWebView.hpp"
+#include "WebPage.hpp"
+
+/*
+ * Web view rendering the page with the tiled backing store and accelerated compositing.
+ * The web item is resized to the contents of the page, so the main frame is scrolled by this view instead of
+ * by WebKit.
+ */
+class TiledWebView : public QGraphicsView {
+    public:
+        TiledWebView(Mode& initialMode, WebPage* initialPage, FrameTimer& initialFrameTimer, Window* initialParent);
+
+        TiledWebView(TiledWebView const&) = delete;
+
+        TiledWebView& operator=(TiledWebView const&) = delete;
+
+        /*
+         * Scroll the page by the specified number of pixels.
+         */
+        void scrollBy(int dx, int dy);
+
+        /*
+         * Get the scroll position.
+         */
+        QPoint scrollPosition() const;
+
+        /*
+         * Set the scroll position.
+         */
+        void setScrollPosition(QPoint const& position);
+
+        /*
+         * Show another page, which becomes a child of the view.
+         * The previous page is not deleted.
+         */
+        void setWebPage(WebPage* newPage);
+
+    protected:
+        virtual void keyPressEvent(QKeyEvent* keyEvent);
+
+        virtual void mousePressEvent(QMouseEvent* mouseEvent);
+
+        virtual void paintEvent(QPaintEvent* paintEvent);
+
+        virtual void resizeEvent(QResizeEvent* resizeEvent);
+
+    private:
+        FrameTimer& frameTimer;
+        Mode& mode;
+        Window* parent;
+        QGraphicsScene scene;
+        QGraphicsWebView* webItem;
+        WebPage* webPage;
+
+        /*
+         * Enable the tiled backing store in the page and show it in the web item.
+         */
+        void showPage();
+};
+
+#endif
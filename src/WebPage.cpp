@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ctime>
+
+#include <QCoreApplication>
+#include <QTimer>
+#include <QWebFrame>
+#include <QWebHitTestResult>
+
+#include "DownscaledImageReply.hpp"
+#include "WebPage.hpp"
+
+qint64 WebPage::lastResponsiveTime = 0;
+
+WebPage::WebPage(SiteProfiles const& profiles, QNetworkAccessManager* networkAccessManager, QObject* parent) : QWebPage(parent), newWindowRequested(), scriptInterrupted(), lastClickPosition(), resourceURLs(), siteProfiles(profiles) {
+    setNetworkAccessManager(networkAccessManager);
+
+    //A script blocks the event loop: the CPU time used since the last beat is the time used by the script.
+    //The pages run their scripts in the same thread, so a single timer serves every page of the process.
+    static QTimer* heartbeat{nullptr};
+    if(nullptr == heartbeat) {
+        heartbeat = new QTimer(QCoreApplication::instance());
+        heartbeat->setInterval(HEARTBEAT_INTERVAL);
+        connect(heartbeat, &QTimer::timeout, &WebPage::beat);
+        heartbeat->start();
+        beat();
+    }
+
+    //Redirections do not go through acceptNavigationRequest().
+    connect(mainFrame(), &QWebFrame::urlChanged, this, &WebPage::applyProfile);
+
+    //The resources are recorded to archive the page.
+    connect(networkAccessManager, &QNetworkAccessManager::finished, this, &WebPage::resourceLoaded);
+    connect(mainFrame(), &QWebFrame::loadStarted, this, [this]() {
+        resourceURLs.clear();
+        downscaledImages = 0;
+        savedImageMemory = 0;
+        reader = readerLoading;
+    });
+    connect(mainFrame(), &QWebFrame::loadFinished, this, [this]() {
+        readerLoading = false;
+    });
+}
+
+bool WebPage::acceptNavigationRequest(QWebFrame* frame, QNetworkRequest const& request, NavigationType type) {
+    //The history copied in a prerendered page would load its current item before the prerendered one.
+    if(isPrerendering() and NavigationTypeBackOrForward == type) {
+        return false;
+    }
+    if(mainFrame() == frame) {
+        applyProfile(request.url());
+    }
+    return QWebPage::acceptNavigationRequest(frame, request, type);
+}
+
+void WebPage::applyProfile(QUrl const& url) {
+    siteProfiles.apply(url.host(), settings());
+    if(reader) {
+        settings()->setAttribute(QWebSettings::JavascriptEnabled, false);
+    }
+}
+
+void WebPage::beat() {
+    lastResponsiveTime = threadTime();
+}
+
+QWebPage* WebPage::createWindow(WebWindowType) {
+    if(newWindowRequested and not isPrerendering()) {
+        QWebHitTestResult result{mainFrame()->hitTestContent(lastClickPosition)};
+        newWindowRequested(result.linkUrl());
+    }
+    return nullptr;
+}
+
+QString WebPage::imageReport() const {
+    return tr("%1 images downscaled, %2 MiB of decoded memory saved").arg(downscaledImages).arg(double(savedImageMemory) / (1024 * 1024), 0, 'f', 1);
+}
+
+bool WebPage::isPrerendering() const {
+    return VisibilityStatePrerender == visibilityState();
+}
+
+bool WebPage::isReader() const {
+    return reader;
+}
+
+void WebPage::javaScriptAlert(QWebFrame* frame, QString const& message) {
+    if(not isPrerendering()) {
+        QWebPage::javaScriptAlert(frame, message);
+    }
+}
+
+bool WebPage::javaScriptConfirm(QWebFrame* frame, QString const& message) {
+    return not isPrerendering() and QWebPage::javaScriptConfirm(frame, message);
+}
+
+bool WebPage::javaScriptPrompt(QWebFrame* frame, QString const& message, QString const& defaultValue, QString* result) {
+    return not isPrerendering() and QWebPage::javaScriptPrompt(frame, message, defaultValue, result);
+}
+
+void WebPage::resourceLoaded(QNetworkReply* reply) {
+    QWebFrame* frame{qobject_cast<QWebFrame*>(reply->request().originatingObject())};
+    if(nullptr != frame and this == frame->page() and QNetworkReply::NoError == reply->error()) {
+        resourceURLs.insert(reply->url());
+        qint64 saved{reply->attribute(DownscaledImageReply::SAVED_MEMORY_ATTRIBUTE).toLongLong()};
+        if(saved > 0) {
+            downscaledImages++;
+            savedImageMemory += saved;
+        }
+    }
+}
+
+QList<QUrl> WebPage::resources() const {
+    return resourceURLs.toList();
+}
+
+void WebPage::setLastClickPosition(QPoint const& position) {
+    lastClickPosition = position;
+}
+
+void WebPage::setScriptBudget(qint64 budget) {
+    scriptBudget = budget;
+}
+
+void WebPage::showReader(QString const& html) {
+    //The original document, its scripts and their memory are dropped.
+    reader = true;
+    readerLoading = true;
+    settings()->setAttribute(QWebSettings::JavascriptEnabled, false);
+    mainFrame()->setHtml(html, mainFrame()->url());
+}
+
+bool WebPage::shouldInterruptJavaScript() {
+    QString host{mainFrame()->url().host()};
+    qint64 budget{siteProfiles.scriptBudget(host, scriptBudget)};
+    qint64 time{threadTime() - lastResponsiveTime};
+    if(0 == budget or time < budget) {
+        return false;
+    }
+
+    qWarning("Interrupted a script of %s after %lld ms of CPU time", qPrintable(host), time);
+    if(scriptInterrupted) {
+        scriptInterrupted(host, time);
+    }
+    beat();
+    return true;
+}
+
+qint64 WebPage::threadTime() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return qint64(time.tv_sec) * 1000 + time.tv_nsec / 1000000;
+}
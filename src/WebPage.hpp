@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WEBPAGE_HPP
+#define WEBPAGE_HPP
+
+#include <functional>
+
+#include <QNetworkReply>
+#include <QSet>
+#include <QUrl>
+#include <QWebPage>
+
+#include "SiteProfiles.hpp"
+
+/*
+ * Web page applying the site profile of the host before each navigation.
+ * It also interrupts the scripts exceeding the CPU time budget of the host.
+ */
+class WebPage : public QWebPage {
+    Q_OBJECT
+
+    public:
+        WebPage(SiteProfiles const& profiles, QNetworkAccessManager* networkAccessManager, QObject* parent = nullptr);
+
+        WebPage(WebPage const&) = delete;
+
+        WebPage& operator=(WebPage const&) = delete;
+
+        /*
+         * Get the number of images downscaled for the current document and the decoded memory saved.
+         */
+        QString imageReport() const;
+
+        /*
+         * Check if the reader view of the page is shown.
+         */
+        bool isReader() const;
+
+        /*
+         * Get the URLs of the resources loaded by the frames of the current document.
+         */
+        QList<QUrl> resources() const;
+
+        /*
+         * Set the position of the last click, used to find the link to open in a new window.
+         */
+        void setLastClickPosition(QPoint const& position);
+
+        /*
+         * Set the CPU time budget in milliseconds of a script for the hosts without one in their profile
+         * (0 means unlimited).
+         */
+        void setScriptBudget(qint64 budget);
+
+        /*
+         * Replace the document by its reader view, with the scripts disabled until another page is loaded.
+         */
+        void showReader(QString const& html);
+
+        /*
+         * Called with the URL of the link to open in a new window.
+         */
+        std::function<void(QUrl const&)> newWindowRequested;
+
+        /*
+         * Called with the host and the CPU time in milliseconds when a script is interrupted.
+         */
+        std::function<void(QString const&, qint64)> scriptInterrupted;
+
+    public slots:
+        /*
+         * Check if the long running script must be interrupted.
+         * QWebPage::shouldInterruptJavaScript() is not virtual: WebKit calls this slot by name.
+         */
+        bool shouldInterruptJavaScript();
+
+    protected:
+        virtual bool acceptNavigationRequest(QWebFrame* frame, QNetworkRequest const& request, NavigationType type);
+
+        virtual QWebPage* createWindow(WebWindowType type);
+
+        virtual void javaScriptAlert(QWebFrame* frame, QString const& message);
+
+        virtual bool javaScriptConfirm(QWebFrame* frame, QString const& message);
+
+        virtual bool javaScriptPrompt(QWebFrame* frame, QString const& message, QString const& defaultValue, QString* result);
+
+    private:
+        static int const HEARTBEAT_INTERVAL = 250;
+
+        static qint64 lastResponsiveTime;
+
+        int downscaledImages = 0;
+        QPoint lastClickPosition;
+        bool reader = false;
+        bool readerLoading = false;
+        QSet<QUrl> resourceURLs;
+        qint64 savedImageMemory = 0;
+        qint64 scriptBudget = 5000;
+        SiteProfiles const& siteProfiles;
+
+        /*
+         * Apply the site profile of the URL host to the page settings.
+         */
+        void applyProfile(QUrl const& url);
+
+        /*
+         * Record the CPU time used by the thread while the event loop is responsive.
+         */
+        static void beat();
+
+        /*
+         * Check if the page is loaded in the background, before being shown: it must not interact with the user.
+         */
+        bool isPrerendering() const;
+
+        /*
+         * Record the resource if it was loaded for a frame of the page.
+         */
+        void resourceLoaded(QNetworkReply* reply);
+
+        /*
+         * Get the CPU time used by the current thread in milliseconds.
+         */
+        static qint64 threadTime();
+};
+
+#endif
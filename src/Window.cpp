@@ -15,40 +15,169 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cmath>
+
 #include <QApplication>
+#include <QDataStream>
+#include <QDateTime>
 #include <QHBoxLayout>
+#include <QFileInfo>
 #include <QKeyEvent>
+#include <QLockFile>
+#include <QMimeDatabase>
+#include <QNetworkDiskCache>
+#include <QNetworkReply>
 #include <QProcess>
+#include <QScrollBar>
+#include <QSet>
+#include <QSettings>
 #include <QShortcut>
+#include <QStandardPaths>
 #include <QStatusBar>
+#include <QTimer>
 #include <QVBoxLayout>
+#include <QVector>
 #include <QWebElementCollection>
 #include <QWebFrame>
 #include <QWebHistory>
 
+#include "ArchiveWriter.hpp"
+#include "ArticleExtractor.hpp"
+#include "HintGenerator.hpp"
+#include "TiledWebView.hpp"
+#include "WebPage.hpp"
 #include "Window.hpp"
 
 using namespace std::placeholders;
 
-Window::Window(QString const& initialURL) : command(), controlKeybindings(), currentTitle(), elementMappings(), homepage(), keybindings() {
+Window::Window(QString const& initialURL, WindowOptions const& initialOptions) : CONFIG_PATH(initialOptions.configPath), archive(), browserContext(CONFIG_PATH, siteProfiles), command(), controlKeybindings(), cookieTimer(), currentTitle(), elementMappings(), exCommands(), frameTimer(), frecency(CONFIG_PATH + "/frecency"), homepage(), idleScheduler(), keybindings(), options(initialOptions), pageIndex(CONFIG_PATH + "/index"), session(CONFIG_PATH + "/session"), sessionState(), sessionTimer(), siteProfiles(CONFIG_PATH + "/profiles.ini") {
     loadConfig();
-    configure();
-    createWidgets();
-    createEvents();
-    loadInitialURLOrHomepage(initialURL);
+    tracePhase("configuration");
+
+    //The other windows see this one before it decides anything from them, such as clearing the session.
+    session.start();
+
+    //This window restores the most recent session file and starts the other windows of the session.
+    QStringList otherSessions;
+    if(options.restore) {
+        otherSessions = session.files();
+        if(not otherSessions.isEmpty()) {
+            options.sessionFile = otherSessions.takeFirst();
+        }
+    }
+    else if(options.sessionFile.isEmpty() and options.replayFile.isEmpty() and not session.hasOtherWindows()) {
+        //A window started alone without --restore starts a new session: the previous one would be restored with it.
+        session.clear();
+    }
+    QUrl url{initialURL.isEmpty() ? homepage : QUrl::fromUserInput(initialURL)};
+    if(not options.sessionFile.isEmpty() and session.load(options.sessionFile, sessionState)) {
+        url = sessionState.url;
+    }
+    else {
+        options.placeholder = false;
+        options.sessionFile.clear();
+    }
+    tracePhase("session");
+
+    createWebView();
+    tracePhase("web view");
+
+    //The requests of the first page are sent while the rest of the window is created.
+    if(options.placeholder) {
+        setAttribute(Qt::WA_ShowWithoutActivating);
+        setWindowTitle(sessionState.title);
+    }
+    else if(not url.isLocalFile()) {
+        if(options.sessionFile.isEmpty()) {
+            page->mainFrame()->load(url);
+        }
+        else {
+            restoreSession();
+        }
+    }
+    tracePhase("first navigation");
+    showMaximized();
+    tracePhase("show");
+
+    QTimer::singleShot(0, this, [this, url, otherSessions]() {
+        initializeDeferred(url, otherSessions);
+    });
+}
+
+Window::~Window() {
+    if(options.frameStats) {
+        qInfo("%s backend: %s", qPrintable(options.backend), qPrintable(frameTimer.report()));
+    }
+    if(nullptr != options.startupTrace) {
+        qInfo("Startup (no page painted):\n%s", qPrintable(options.startupTrace->report()));
+    }
+
+    //Every window quit is restored with the session, unless it was closed on purpose. A replayed window is not part of
+    //the session.
+    if(nullptr == keyReplayer and not leavingSession) {
+        saveSession();
+    }
+
+    //The archives, the cookies and the session written in the background are not lost when the window is closed before
+    //being idle.
+    idleScheduler.finishBackgroundTasks();
+    browserContext.cookieJar()->save();
+
+    if(leavingSession) {
+        session.remove();
+    }
+    session.close();
+}
+
+void Window::changeEvent(QEvent* event) {
+    QMainWindow::changeEvent(event);
+
+    //A restored window loads its page when it is first focused.
+    if(options.placeholder and QEvent::ActivationChange == event->type() and isActiveWindow()) {
+        options.placeholder = false;
+        if(sessionState.url.isLocalFile()) {
+            loadURL(sessionState.url);
+        }
+        else {
+            restoreSession();
+        }
+    }
+
+    if(nullptr != throttler and (QEvent::ActivationChange == event->type() or QEvent::WindowStateChange == event->type())) {
+        if(isActiveWindow() and not isMinimized()) {
+            QString report{throttler->resume()};
+            if(not report.isEmpty()) {
+                statusBar()->showMessage(report, 5000);
+            }
+        }
+        else {
+            throttler->throttle();
+        }
+    }
 }
 
 void Window::clearSearch() {
-    webView->findText("", findFlags & ~QWebPage::HighlightAllOccurrences);
-    webView->findText("", findFlags);
+    textViewer->find("", false);
+    page->findText("", findFlags & ~QWebPage::HighlightAllOccurrences);
+    page->findText("", findFlags);
 }
 
 void Window::click(QWebElement const& element) {
-    QPoint position{element.geometry().center() - currentFrame()->scrollPosition()};
+    QPoint position{element.geometry().center() - scrollPosition()};
     QMouseEvent *pressEvent = new QMouseEvent(QMouseEvent::MouseButtonPress, position, Qt::MouseButton::LeftButton, Qt::LeftButton, Qt::NoModifier);
-    QApplication::postEvent(webView, pressEvent);
+    QApplication::postEvent(webViewport(), pressEvent);
     QMouseEvent* releaseEvent = new QMouseEvent(QMouseEvent::MouseButtonRelease, position, Qt::MouseButton::LeftButton, Qt::LeftButton, Qt::NoModifier);
-    QApplication::postEvent(webView, releaseEvent);
+    QApplication::postEvent(webViewport(), releaseEvent);
+}
+
+void Window::closeArchive() {
+    networkAccessManager->setArchive(nullptr);
+    archive.reset();
+}
+
+void Window::closeWindow() {
+    leavingSession = true;
+    qApp->quit();
 }
 
 void Window::commandMode() {
@@ -58,23 +187,41 @@ void Window::commandMode() {
 }
 
 void Window::configure() {
-    showMaximized();
-
     QDir::home().mkdir(CONFIG_PATH);
+    page->settings()->setIconDatabasePath(CONFIG_PATH);
+    idleScheduler.scheduleInBackground(std::bind(&Frecency::load, &frecency));
+    idleScheduler.scheduleInBackground(std::bind(&Window::removeStaleCaches, this));
+}
+
+void Window::connectPage() {
+    connect(page->mainFrame(), &QWebFrame::titleChanged, this, &Window::titleChanged);
+    connect(page, &QWebPage::loadStarted, this, &Window::loadStarted);
+    connect(page, &QWebPage::loadFinished, this, &Window::loadFinished);
+    connect(page, &QWebPage::loadProgress, this, &Window::loadProgress);
+    connect(page->mainFrame(), &QWebFrame::urlChanged, this, &Window::urlChanged);
+    connect(page->mainFrame(), &QWebFrame::iconChanged, this, &Window::iconChanged);
+    connect(page, &QWebPage::linkHovered, this, &Window::linkHovered);
+    connect(page, &QWebPage::unsupportedContent, this, &Window::unsupportedContent);
+    connect(page, &QWebPage::downloadRequested, this, [this](QNetworkRequest const& request) {
+        downloadManager->download(request.url());
+    });
 }
 
 void Window::createEvents() {
-    connect(webView, &QWebView::titleChanged, this, &Window::titleChanged);
-    connect(webView, &QWebView::loadStarted, this, &Window::loadStarted);
-    connect(webView, &QWebView::loadFinished, this, &Window::loadFinished);
-    connect(webView, &QWebView::loadProgress, this, &Window::loadProgress);
-    connect(webView, &QWebView::urlChanged, this, &Window::urlChanged);
-    connect(webView, &QWebView::iconChanged, this, &Window::iconChanged);
-    connect(webView->page(), &QWebPage::linkHovered, this, &Window::linkHovered);
-    //TODO: connect(webView, &QWebView::statusBarMessage, this, &Window::statusBarMessage);
+    connectPage();
+    downloadManager->progressChanged = std::bind(&Window::downloadProgress, this, _1, _2, _3);
+    //TODO: connect(page, &QWebPage::statusBarMessage, this, &Window::statusBarMessage);
 }
 
-void Window::createWidgets() {
+WebPage* Window::createPage() {
+    WebPage* newPage{browserContext.createPage()};
+    newPage->scriptInterrupted = std::bind(&Window::scriptInterrupted, this, _1, _2);
+    newPage->newWindowRequested = std::bind(&Window::openNewWindow, this, _1);
+    newPage->setForwardUnsupportedContent(true);
+    return newPage;
+}
+
+void Window::createWebView() {
     QWidget* widget = new QWidget;
     QVBoxLayout* vbox = new QVBoxLayout;
     vbox->setContentsMargins(0, 0, 0, 0);
@@ -82,10 +229,62 @@ void Window::createWidgets() {
     setCentralWidget(widget);
 
     //The web view.
-    webView = new ModalWebView(mode, this);
-    webView->settings()->setIconDatabasePath(CONFIG_PATH);
+    networkAccessManager = browserContext.createNetworkAccessManager(session.hasOtherWindows(), this);
+    page = createPage();
+    if("tiled" == options.backend) {
+        tiledWebView = new TiledWebView(mode, page, frameTimer, this);
+        webView = tiledWebView;
+    }
+    else {
+        modalWebView = new ModalWebView(mode, page, frameTimer, this);
+        webView = modalWebView;
+    }
     vbox->addWidget(webView);
 
+    if(nullptr != options.startupTrace) {
+        //The first frame painted after the first layout shows the page.
+        connect(page->mainFrame(), &QWebFrame::initialLayoutCompleted, this, [this]() {
+            tracePhase("first layout");
+            frameTimer.frameTimed = [this]() {
+                if(nullptr != options.startupTrace) {
+                    tracePhase("first paint");
+                    qInfo("Startup:\n%s", qPrintable(options.startupTrace->report()));
+                    options.startupTrace = nullptr;
+                }
+            };
+        });
+    }
+
+    //The viewer for huge text files.
+    textViewer = new TextViewer(this);
+    textViewer->hide();
+    vbox->addWidget(textViewer);
+}
+
+void Window::createWidgets() {
+    if(throttleEnabled) {
+        throttler = new Throttler(webView, page, throttleInterval);
+    }
+
+    if(prerenderEnabled) {
+        prerenderer = new Prerenderer(std::bind(&Window::createPage, this), prerenderBudget * 1024 * 1024, this);
+    }
+
+    if(not options.recordFile.isEmpty()) {
+        keyRecorder = new KeyRecorder(options.recordFile, this, this);
+    }
+    if(not options.replayFile.isEmpty()) {
+        keyReplayer = new KeyReplayer(options.replayFile, this, this);
+        keyReplayer->finished = [this]() {
+            qInfo("Replay of %s:\n%s", qPrintable(options.replayFile), qPrintable(keyReplayer->report()));
+            qApp->quit();
+        };
+    }
+
+    downloadManager = new DownloadManager(networkAccessManager, QStandardPaths::writableLocation(QStandardPaths::DownloadLocation), this);
+    downloadManager->setConnectionCount(downloadConnections);
+    downloadManager->setRateLimit(downloadRateLimit);
+
     //The status bar.
     statusBar()->setContentsMargins(5, 0, 5, 0);
 
@@ -115,25 +314,82 @@ void Window::createWidgets() {
     scrollValueLabel->setFont(labelFont);
     statusBar()->addPermanentWidget(scrollValueLabel);
 
+    //The resource monitor.
+    if(monitorEnabled) {
+        resourceMonitor = new ResourceMonitor(browserContext.diskCache(), monitorMemoryThreshold * 1024 * 1024, monitorCpuThreshold);
+        resourceMonitor->setFont(labelFont);
+        statusBar()->addPermanentWidget(resourceMonitor);
+    }
+
     //The progress bar.
     progressBar = new QProgressBar;
     progressBar->setMaximumWidth(100);
     progressBar->hide();
     statusBar()->addPermanentWidget(progressBar);
+
+    //The download progress bar.
+    downloadProgressBar = new QProgressBar;
+    downloadProgressBar->setMaximumWidth(200);
+    downloadProgressBar->hide();
+    statusBar()->addPermanentWidget(downloadProgressBar);
 }
 
 QWebFrame* Window::currentFrame() const {
-    return webView->page()->currentFrame();
+    return page->currentFrame();
+}
+
+void Window::downloadProgress(qint64 received, qint64 total, QStringList const& names) {
+    if(names.isEmpty()) {
+        downloadProgressBar->hide();
+        return;
+    }
+
+    //Unknown sizes make the progress bar busy.
+    downloadProgressBar->setMaximum(total > 0 ? 1000 : 0);
+    downloadProgressBar->setValue(total > 0 ? int(received * 1000 / total) : 0);
+    downloadProgressBar->setFormat(names.join(", ") + " %p%");
+    downloadProgressBar->show();
+}
+
+QString Window::elementKey(QWebElement const& element) const {
+    if("A" == element.tagName()) {
+        return currentFrame()->baseUrl().resolved(QUrl(element.attribute("href"))).toString();
+    }
+    return element.tagName() + "#" + (element.hasAttribute("id") ? element.attribute("id") : element.attribute("name"));
+}
+
+void Window::exCommand() {
+    QStringList arguments{lineEdit->text().split(' ', QString::SkipEmptyParts)};
+    normalMode();
+    if(arguments.isEmpty()) {
+        return;
+    }
+
+    QString name{arguments.takeFirst()};
+    auto it(exCommands.find(name));
+    if(it == exCommands.end()) {
+        statusBar()->showMessage(tr("Unknown command: %1").arg(name), 5000);
+        return;
+    }
+    (*it)(this, arguments);
 }
 
 void Window::findNext() {
-    webView->findText(searchText, findFlags & ~QWebPage::HighlightAllOccurrences);
-    webView->findText(searchText, findFlags);
+    if(textViewer->isVisible()) {
+        textViewer->find(searchText, findFlags.testFlag(QWebPage::FindBackward));
+        return;
+    }
+    page->findText(searchText, findFlags & ~QWebPage::HighlightAllOccurrences);
+    page->findText(searchText, findFlags);
 }
 
 void Window::findPrevious() {
-    webView->findText(searchText, (findFlags xor QWebPage::FindBackward) & ~QWebPage::HighlightAllOccurrences);
-    webView->findText(searchText, findFlags xor QWebPage::FindBackward);
+    if(textViewer->isVisible()) {
+        textViewer->find(searchText, not findFlags.testFlag(QWebPage::FindBackward));
+        return;
+    }
+    page->findText(searchText, (findFlags xor QWebPage::FindBackward) & ~QWebPage::HighlightAllOccurrences);
+    page->findText(searchText, findFlags xor QWebPage::FindBackward);
 }
 
 void Window::focusNextField() {
@@ -145,7 +401,7 @@ void Window::focusNextField() {
         if(elementRect.width() > 0 and elementRect.height() > 0) {
             if(elementCount == fieldIndex and not done) {
                 if(not isVisible(*it)) {
-                    currentFrame()->setScrollPosition((*it).geometry().topLeft());
+                    setScrollPosition((*it).geometry().topLeft());
                 }
                 click(*it);
                 done = true;
@@ -156,22 +412,65 @@ void Window::focusNextField() {
     fieldIndex = (fieldIndex + 1) % elementCount;
 }
 
+double Window::hintWeight(QWebElement const& element) {
+    QSize size{viewportSize()};
+    QRect viewport{scrollPosition(), size};
+    QRect elementRect{element.geometry()};
+    double area{double(elementRect.width()) * elementRect.height() / std::max(1.0, double(size.width()) * size.height())};
+    QPoint offset{elementRect.center() - viewport.center()};
+    double distance{std::hypot(offset.x(), offset.y()) / std::max(1.0, std::hypot(size.width() / 2.0, size.height() / 2.0))};
+    //The followed targets come first, then the big ones close to the center of the viewport.
+    return 1.0 + FRECENCY_WEIGHT * frecency.score(page->mainFrame()->url().host(), elementKey(element)) + std::sqrt(std::min(1.0, area)) + std::max(0.0, 1.0 - distance);
+}
+
 void Window::historyBack() {
-    webView->history()->back();
+    if(textViewer->isVisible()) {
+        showWebView();
+        return;
+    }
+    page->history()->back();
 }
 
 void Window::historyForward() {
-    webView->history()->forward();
+    page->history()->forward();
 }
 
 void Window::iconChanged() {
-    setWindowIcon(webView->icon());
+    setWindowIcon(page->mainFrame()->icon());
 }
 
 void Window::incrementalSearch(QString const& text) {
     clearSearch();
+    if(textViewer->isVisible()) {
+        textViewer->find(text, findFlags.testFlag(QWebPage::FindBackward));
+        return;
+    }
     //TODO: improve search performance (perhaps using a thread).
-    webView->findText(text, findFlags);
+    page->findText(text, findFlags);
+}
+
+void Window::indexSearch() {
+    QString query{lineEdit->text()};
+    QList<PageIndex::Result> results{pageIndex.search(query, MAX_INDEX_RESULTS)};
+    normalMode();
+
+    if(1 == results.size()) {
+        loadURL(QUrl(results.first().url));
+        return;
+    }
+
+    QString html{"<html><head><title>" + tr("Search") + ": " + query.toHtmlEscaped() + "</title></head><body><ul>"};
+    for(PageIndex::Result const& result : results) {
+        html += "<li><a href=\"" + result.url.toHtmlEscaped() + "\">" + (result.title.isEmpty() ? result.url : result.title).toHtmlEscaped() + "</a><br><small>" + result.url.toHtmlEscaped() + "</small></li>";
+    }
+    html += "</ul>";
+    if(results.isEmpty()) {
+        html += "<p>" + tr("No results") + "</p>";
+    }
+    html += "</body></html>";
+
+    showWebView();
+    page->mainFrame()->setHtml(html);
 }
 
 void Window::insertMode() {
@@ -179,16 +478,67 @@ void Window::insertMode() {
     modeLabel->setText("-- " + tr("INSERT MODE") + " --");
 }
 
+void Window::initializeDeferred(QUrl const& firstURL, QStringList const& otherSessions) {
+    configure();
+    createWidgets();
+    createEvents();
+
+    if(options.placeholder) {
+        titleChanged(sessionState.title);
+        urlChanged(sessionState.url);
+    }
+    //The local files may be shown in the text viewer, which needs the status bar.
+    else if(firstURL.isLocalFile()) {
+        loadURL(firstURL);
+    }
+    else {
+        //The first navigation started before the events were connected.
+        loadStarted();
+    }
+
+    for(QString const& file : otherSessions) {
+        QProcess::startDetached(qApp->applicationFilePath(), {"--backend", options.backend, "--placeholder", "--session", file});
+    }
+    if(cookieInterval > 0) {
+        //The cookies changed since the last flush are written together, in the background.
+        connect(&cookieTimer, &QTimer::timeout, this, [this]() {
+            std::function<void()> task{browserContext.cookieJar()->flushTask()};
+            if(task) {
+                idleScheduler.scheduleInBackground(task);
+            }
+        });
+        cookieTimer.start(cookieInterval);
+    }
+    if(sessionInterval > 0 and nullptr == keyReplayer) {
+        //The timer is restarted once the session is saved, so that a single snapshot waits for the idle period.
+        sessionTimer.setSingleShot(true);
+        connect(&sessionTimer, &QTimer::timeout, this, [this]() {
+            idleScheduler.schedule([this]() {
+                saveSession();
+                sessionTimer.start();
+                return true;
+            });
+        });
+        sessionTimer.start(sessionInterval);
+    }
+    tracePhase("deferred initialization");
+}
+
 bool Window::isFollow() const {
     return Mode::FOLLOW == mode;
 }
 
+bool Window::isTiledScrolling() const {
+    return nullptr != tiledWebView and page->mainFrame() == currentFrame();
+}
+
 bool Window::isVisible(QWebElement const& element) {
-    QSize viewportSize{webView->page()->viewportSize()};
-    int x1{currentFrame()->scrollBarValue(Qt::Horizontal)};
-    int y1{currentFrame()->scrollBarValue(Qt::Vertical)};
-    int x2{x1 + viewportSize.width()};
-    int y2{y1 + viewportSize.height()};
+    QSize size{viewportSize()};
+    QPoint position{scrollPosition()};
+    int x1{position.x()};
+    int y1{position.y()};
+    int x2{x1 + size.width()};
+    int y2{y1 + size.height()};
     QRect elementRect{element.geometry()};
     return elementRect.width() > 0 and elementRect.height() > 0 and elementRect.x() >= x1 and elementRect.x() <= x2 and elementRect.y() >= y1 and elementRect.y() <= y2;
 }
@@ -209,6 +559,9 @@ void Window::keyPressEvent(QKeyEvent* keyEvent) {
     else if(Mode::NORMAL == mode and Qt::Key_Question == key) {
         showBackwardSearchField();
     }
+    else if(Mode::NORMAL == mode and Qt::Key_Colon == key) {
+        showExCommand();
+    }
     else if(Mode::NORMAL == mode or isFollow()) {
         QChar charKey{key};
         if(Qt::Key_Backspace == key) {
@@ -240,7 +593,7 @@ void Window::keyPressEvent(QKeyEvent* keyEvent) {
 
 void Window::linkHovered(QString const& link, QString const&, QString const&) {
     if(link.isEmpty()) {
-        urlLabel->setText(webView->url().toString());
+        urlLabel->setText(page->mainFrame()->url().toString());
     }
     else {
         urlLabel->setText(link);
@@ -251,6 +604,26 @@ void Window::loadConfig() {
     homepage = QUrl("http://ixquick.com");
     statusBarFontSize = 12;
 
+    QSettings config{CONFIG_PATH + "/config.ini", QSettings::IniFormat};
+    browserContext.loadConfig(config);
+    cookieInterval = config.value("cookies/interval", cookieInterval).toInt();
+    downloadConnections = config.value("download/connections", downloadConnections).toInt();
+    downloadRateLimit = config.value("download/rate", downloadRateLimit).toLongLong();
+    hintAlphabet = config.value("hints/alphabet", hintAlphabet).toString();
+    idleScheduler.setDelay(config.value("idle/delay", 500).toInt());
+    if(options.backend.isEmpty()) {
+        options.backend = config.value("view/backend", "widget").toString();
+    }
+    monitorCpuThreshold = config.value("monitor/cpu", monitorCpuThreshold).toInt();
+    monitorEnabled = config.value("monitor/enabled", monitorEnabled).toBool();
+    monitorMemoryThreshold = config.value("monitor/memory", monitorMemoryThreshold).toLongLong();
+    prerenderBudget = config.value("prerender/budget", prerenderBudget).toLongLong();
+    prerenderEnabled = config.value("prerender/enabled", prerenderEnabled).toBool();
+    sessionInterval = config.value("session/interval", sessionInterval).toInt();
+    textViewerThreshold = config.value("viewer/threshold", textViewerThreshold).toLongLong();
+    throttleEnabled = config.value("throttle/enabled", throttleEnabled).toBool();
+    throttleInterval = config.value("throttle/interval", throttleInterval).toInt();
+
     keybindings["b"] = std::bind(&Window::historyBack, _1);
     keybindings["é"] = std::bind(&Window::historyForward, _1);
     keybindings["e"] = std::bind(&Window::pageReload, _1);
@@ -263,12 +636,16 @@ void Window::loadConfig() {
     keybindings["o"] = std::bind(&Window::showOpen, _1);
     keybindings["O"] = std::bind(&Window::showWindowOpen, _1);
     keybindings["go"] = std::bind(&Window::showOpenWithCurrentURL, _1);
+    keybindings["gs"] = std::bind(&Window::showIndexSearch, _1);
     keybindings["i"] = std::bind(&Window::insertMode, _1);
+    keybindings["ZQ"] = std::bind(&Window::closeWindow, _1);
     keybindings["ZZ"] = std::bind(&Window::quit, _1);
     keybindings["f"] = std::bind(&Window::showFollowLabels, _1);
     keybindings["F"] = std::bind(&Window::showFollowLabelsNewWindow, _1);
     keybindings["a"] = std::bind(&Window::showFollowLabelsSameWindow, _1);
     keybindings["gi"] = std::bind(&Window::focusNextField, _1);
+    keybindings["gn"] = std::bind(&Window::showNextPage, _1);
+    keybindings["gr"] = std::bind(&Window::toggleReader, _1);
     keybindings["n"] = std::bind(&Window::findNext, _1);
     keybindings["N"] = std::bind(&Window::findPrevious, _1);
 
@@ -276,6 +653,10 @@ void Window::loadConfig() {
     controlKeybindings['d'] = std::bind(&Window::scrollDownHalfPage, _1);
     controlKeybindings['f'] = std::bind(&Window::scrollDownPage, _1);
     controlKeybindings['u'] = std::bind(&Window::scrollUpHalfPage, _1);
+
+    exCommands["images"] = std::bind(&Window::showImageStatistics, _1);
+    exCommands["netstats"] = std::bind(&Window::showNetworkStatistics, _1);
+    exCommands["save"] = std::bind(&Window::saveArchive, _1, _2);
 }
 
 void Window::loadFinished() {
@@ -284,24 +665,58 @@ void Window::loadFinished() {
     setTitle();
     updateScrollLabel();
     progressBar->hide();
-}
 
-void Window::loadInitialURLOrHomepage(QString const& initialURL) {
-    if(initialURL.isEmpty()) {
-        webView->load(homepage);
+    if(restoringSession) {
+        restoringSession = false;
+        setScrollPosition(sessionState.scrollPosition);
+        if(int(Mode::INSERT) == sessionState.mode) {
+            insertMode();
+        }
     }
-    else {
-        webView->load(QUrl::fromUserInput(initialURL));
+
+    //The pages of the hosts whose profile enables the reader mode are replaced by their article once loaded.
+    QUrl url{page->mainFrame()->url()};
+    if(readerSkipped) {
+        readerSkipped = false;
+    }
+    else if(not page->isReader() and siteProfiles.readerEnabled(url.host()) and showReader()) {
+        return;
+    }
+
+    //The text is extracted when idle, if the page is still shown, and indexed in the background.
+    if("http" == url.scheme() or "https" == url.scheme() or "file" == url.scheme()) {
+        idleScheduler.schedule([this, url]() {
+            if(page->mainFrame()->url() == url) {
+                pageIndex.add(url, page->mainFrame()->title(), page->mainFrame()->toPlainText());
+            }
+            return true;
+        });
+    }
+
+    if(nullptr != prerenderer) {
+        //The links are searched a few at a time, while the page is still shown.
+        std::function<bool()> step{prerenderer->prerenderTask(page)};
+        WebPage* shownPage{page};
+        idleScheduler.schedule([this, url, step, shownPage]() {
+            return page != shownPage or page->mainFrame()->url() != url or step();
+        });
+    }
+
+    //The keys are replayed once the first page is loaded.
+    if(nullptr != keyReplayer) {
+        keyReplayer->start();
     }
 }
 
 void Window::loadProgress(int progress) {
+    idleScheduler.activity();
     progression = progress;
     setTitle();
     progressBar->setValue(progress);
 }
 
 void Window::loadStarted() {
+    idleScheduler.activity();
     setWindowIcon(QIcon());
     normalMode();
     inProgress = true;
@@ -309,18 +724,12 @@ void Window::loadStarted() {
     progressBar->show();
 }
 
-void Window::nextMapping(QString& mapping) {
-    if('z' == mapping[0]) {
-        int index{0};
-        while(index < mapping.size() and 'z' == mapping[index]) {
-            mapping[index] = 'a';
-            mapping[index + 1] = mapping[index + 1].toLatin1() + 1;
-            index++;
-        }
-    }
-    else {
-        mapping[0] = mapping[0].toLatin1() + 1;
+void Window::loadURL(QUrl const& url) {
+    if(openArchive(url) or openInTextViewer(url)) {
+        return;
     }
+    showWebView();
+    page->mainFrame()->load(url);
 }
 
 void Window::normalMode() {
@@ -337,24 +746,72 @@ void Window::normalMode() {
 }
 
 void Window::open() {
-    webView->load(QUrl::fromUserInput(lineEdit->text()));
+    loadURL(QUrl::fromUserInput(lineEdit->text()));
     normalMode();
 }
 
+bool Window::openArchive(QUrl const& url) {
+    if(not url.isLocalFile() or not url.toLocalFile().endsWith(Archive::SUFFIX)) {
+        return false;
+    }
+
+    std::unique_ptr<Archive> opened{new Archive(url.toLocalFile())};
+    if(not opened->isValid()) {
+        statusBar()->showMessage(tr("Invalid archive: %1").arg(url.toLocalFile()), 5000);
+        return false;
+    }
+
+    //The resources of the archive are served from the mapped file until a page outside of it is shown.
+    archive = std::move(opened);
+    networkAccessManager->setArchive(archive.get());
+    showWebView();
+    page->mainFrame()->load(archive->mainURL());
+    return true;
+}
+
+bool Window::openInTextViewer(QUrl const& url) {
+    if(not url.isLocalFile()) {
+        return false;
+    }
+
+    QFileInfo info{url.toLocalFile()};
+    if(not info.isFile() or info.size() < textViewerThreshold) {
+        return false;
+    }
+
+    QMimeType mimeType{QMimeDatabase().mimeTypeForFile(info)};
+    if(not mimeType.inherits("text/plain") and not mimeType.inherits("application/json") and "json" != info.suffix().toLower()) {
+        return false;
+    }
+
+    if(not textViewer->open(info.filePath())) {
+        return false;
+    }
+
+    webView->hide();
+    textViewer->show();
+    textViewer->setFocus();
+    titleChanged(info.fileName());
+    urlLabel->setText(url.toString());
+    updateScrollLabel();
+    return true;
+}
+
 void Window::openNewWindow(QUrl const& newURL) {
     QStringList arguments;
-    arguments << newURL.toString();
+    arguments << "--backend" << options.backend << newURL.toString();
     QProcess::startDetached(qApp->applicationFilePath(), arguments);
 }
 
 void Window::pageReload() {
-    webView->reload();
+    page->triggerAction(QWebPage::Reload);
 }
 
 void Window::processCommand() {
     if(isFollow()) {
         if(elementMappings.contains(command)) {
             QWebElement& element = elementMappings[command];
+            frecency.visit(page->mainFrame()->url().host(), elementKey(element));
 
             if(FollowMode::NORMAL == followMode) {
                 click(element);
@@ -368,14 +825,14 @@ void Window::processCommand() {
                 QString href{element.attribute("href")};
                 QUrl url{href};
                 if(url.scheme().isEmpty()) {
-                    QUrl currentURL{webView->url()};
+                    QUrl currentURL{page->mainFrame()->url()};
                     url = QUrl(currentURL.scheme() + "://" + currentURL.host() + href);
                 }
                 if(FollowMode::NEW_WINDOW == followMode) {
                     openNewWindow(url);
                 }
                 else {
-                    webView->load(url);
+                    page->mainFrame()->load(url);
                 }
                 normalMode();
             }
@@ -418,56 +875,247 @@ void Window::removeLabels() {
 void Window::resizeEvent(QResizeEvent* windowResizeEvent) {
     QWidget::resizeEvent(windowResizeEvent);
 
-    if(nullptr != webView and nullptr != webView->page()) {
+    if(nullptr != page) {
         updateScrollLabel();
     }
 }
 
+void Window::removeStaleCaches() {
+    QDir directory{CONFIG_PATH + "/cache"};
+    for(QString const& name : directory.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        QLockFile lock{directory.filePath(name) + ".lock"};
+        lock.setStaleLockTime(0);
+        if(lock.tryLock(0)) {
+            QDir(directory.filePath(name)).removeRecursively();
+        }
+    }
+}
+
+void Window::restoreSession() {
+    //Restoring the history loads its current item.
+    QDataStream stream{sessionState.history};
+    stream >> *page->history();
+    if(0 == page->history()->count()) {
+        page->mainFrame()->load(sessionState.url);
+    }
+    restoringSession = true;
+}
+
+void Window::saveArchive(QStringList const& arguments) {
+    QUrl url{page->mainFrame()->url()};
+    QString name{arguments.isEmpty() ? url.host() + "-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") : arguments.first()};
+    if(name.isEmpty() or name.contains('/') or name.contains("..")) {
+        statusBar()->showMessage(tr("Invalid archive name: %1").arg(name), 5000);
+        return;
+    }
+    QString directory{CONFIG_PATH + "/archives"};
+    QDir().mkpath(directory);
+    QString path{directory + "/" + name + Archive::SUFFIX};
+
+    //The documents are serialized from their DOM in the GUI thread.
+    struct Document {
+        QUrl url;
+        QByteArray html;
+    };
+    QVector<Document> documents;
+    QSet<QString> archived;
+    std::function<void(QWebFrame*)> addFrame = [&](QWebFrame* frame) {
+        if(not archived.contains(Archive::key(frame->url()))) {
+            archived.insert(Archive::key(frame->url()));
+            documents.append({frame->url(), frame->toHtml().toUtf8()});
+        }
+        for(QWebFrame* child : frame->childFrames()) {
+            addFrame(child);
+        }
+    };
+    addFrame(page->mainFrame());
+    QList<QUrl> resources;
+    for(QUrl const& resource : page->resources()) {
+        if(not archived.contains(Archive::key(resource))) {
+            archived.insert(Archive::key(resource));
+            resources.append(resource);
+        }
+    }
+
+    //The other resources are read from the cache files one at a time, in the background.
+    QString cacheDirectory{browserContext.diskCache()->cacheDirectory()};
+    statusBar()->showMessage(tr("Saving %1 resources to %2").arg(documents.size() + resources.size()).arg(path), 5000);
+    idleScheduler.scheduleInBackground([this, path, documents, resources, cacheDirectory]() mutable {
+        ArchiveWriter writer{path};
+        for(Document& document : documents) {
+            writer.add(document.url, "text/html; charset=utf-8", document.html);
+            //The document is released as soon as it is written.
+            document.html.clear();
+        }
+
+        //The cache of the window is not thread-safe: another instance reads the same files.
+        QNetworkDiskCache cache;
+        cache.setCacheDirectory(cacheDirectory);
+        int missing{0};
+        for(QUrl const& resource : resources) {
+            std::unique_ptr<QIODevice> device{cache.data(resource)};
+            if(nullptr == device) {
+                missing++;
+                continue;
+            }
+            QByteArray contentType;
+            for(auto const& header : cache.metaData(resource).rawHeaders()) {
+                if(0 == header.first.compare("content-type", Qt::CaseInsensitive)) {
+                    contentType = header.second;
+                }
+            }
+            writer.add(resource, contentType, device->readAll());
+        }
+
+        bool saved{writer.commit()};
+        QMetaObject::invokeMethod(this, [this, path, saved, missing]() {
+            statusBar()->showMessage(saved ? tr("Saved %1 (%2 resources not cached)").arg(path).arg(missing) : tr("Cannot save %1").arg(path), 5000);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void Window::saveSession() {
+    //A placeholder keeps the state it was restored from.
+    if(options.placeholder) {
+        return;
+    }
+
+    SessionState state;
+    QDataStream stream{&state.history, QIODevice::WriteOnly};
+    stream << *page->history();
+    state.mode = int(mode);
+    state.scrollPosition = scrollPosition();
+    state.title = page->mainFrame()->title();
+    state.url = page->mainFrame()->url();
+
+    //Only the history is serialized in the GUI thread: it is compressed and written in the background.
+    idleScheduler.scheduleInBackground([this, state]() {
+        session.save(state);
+    });
+}
+
+void Window::scriptInterrupted(QString const& host, qint64 time) {
+    statusBar()->showMessage(tr("Interrupted a script of %1 after %2 ms").arg(host).arg(time), 5000);
+}
+
+void Window::scrollBy(int dx, int dy) {
+    if(isTiledScrolling()) {
+        tiledWebView->scrollBy(dx, dy);
+    }
+    else {
+        currentFrame()->scroll(dx, dy);
+    }
+}
+
 void Window::scrollDown() {
-    currentFrame()->scroll(0, SCROLL_DELTA);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(0, SCROLL_DELTA);
+    }
+    else {
+        scrollBy(0, SCROLL_DELTA);
+    }
     updateScrollLabel();
 }
 
 void Window::scrollDownHalfPage() {
-    currentFrame()->scroll(0, (webView->page()->viewportSize().height() - SCROLL_DELTA) / 2);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(0, (textViewer->height() - SCROLL_DELTA) / 2);
+    }
+    else {
+        scrollBy(0, (viewportSize().height() - SCROLL_DELTA) / 2);
+    }
     updateScrollLabel();
 }
 
 void Window::scrollDownPage() {
-    currentFrame()->scroll(0, webView->page()->viewportSize().height() - SCROLL_DELTA);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(0, textViewer->height() - SCROLL_DELTA);
+    }
+    else {
+        scrollBy(0, viewportSize().height() - SCROLL_DELTA);
+    }
     updateScrollLabel();
 }
 
 void Window::scrollLeft() {
-    currentFrame()->scroll(-SCROLL_DELTA, 0);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(-SCROLL_DELTA, 0);
+    }
+    else {
+        scrollBy(-SCROLL_DELTA, 0);
+    }
 }
 
 void Window::scrollRight() {
-    currentFrame()->scroll(SCROLL_DELTA, 0);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(SCROLL_DELTA, 0);
+    }
+    else {
+        scrollBy(SCROLL_DELTA, 0);
+    }
 }
 
 void Window::scrollUp() {
-    currentFrame()->scroll(0, -SCROLL_DELTA);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(0, -SCROLL_DELTA);
+    }
+    else {
+        scrollBy(0, -SCROLL_DELTA);
+    }
     updateScrollLabel();
 }
 
 void Window::scrollUpHalfPage() {
-    currentFrame()->scroll(0, (- webView->page()->viewportSize().height() + SCROLL_DELTA) / 2);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(0, (- textViewer->height() + SCROLL_DELTA) / 2);
+    }
+    else {
+        scrollBy(0, (- viewportSize().height() + SCROLL_DELTA) / 2);
+    }
     updateScrollLabel();
 }
 
 void Window::scrollUpPage() {
-    currentFrame()->scroll(0, - webView->page()->viewportSize().height() + SCROLL_DELTA);
+    if(textViewer->isVisible()) {
+        textViewer->scrollBy(0, - textViewer->height() + SCROLL_DELTA);
+    }
+    else {
+        scrollBy(0, - viewportSize().height() + SCROLL_DELTA);
+    }
     updateScrollLabel();
 }
 
+int Window::scrollMaximum() const {
+    if(isTiledScrolling()) {
+        return tiledWebView->verticalScrollBar()->maximum();
+    }
+    return currentFrame()->scrollBarMaximum(Qt::Vertical);
+}
+
+QPoint Window::scrollPosition() const {
+    if(isTiledScrolling()) {
+        return tiledWebView->scrollPosition();
+    }
+    return currentFrame()->scrollPosition();
+}
+
 void Window::scrollToBottom() {
-    currentFrame()->setScrollBarValue(Qt::Vertical, currentFrame()->scrollBarMaximum(Qt::Vertical));
+    if(textViewer->isVisible()) {
+        textViewer->scrollToBottom();
+    }
+    else {
+        setScrollPosition(QPoint(scrollPosition().x(), scrollMaximum()));
+    }
     updateScrollLabel();
 }
 
 void Window::scrollToTop() {
-    currentFrame()->setScrollBarValue(Qt::Vertical, 0);
+    if(textViewer->isVisible()) {
+        textViewer->scrollToTop();
+    }
+    else {
+        setScrollPosition(QPoint(scrollPosition().x(), 0));
+    }
     updateScrollLabel();
 }
 
@@ -477,6 +1125,15 @@ void Window::search() {
     findNext();
 }
 
+void Window::setScrollPosition(QPoint const& position) {
+    if(isTiledScrolling()) {
+        tiledWebView->setScrollPosition(position);
+    }
+    else {
+        currentFrame()->setScrollPosition(position);
+    }
+}
+
 void Window::setTitle() {
     QString newTitle{currentTitle};
     if(inProgress) {
@@ -491,42 +1148,45 @@ void Window::showBackwardSearchField() {
     showSearchField();
 }
 
+void Window::showExCommand() {
+    modeLabel->setText(":");
+    commandMode();
+    connect(lineEdit, &QLineEdit::returnPressed, this, &Window::exCommand);
+}
+
 void Window::showFollowLabels() {
     mode = Mode::FOLLOW;
     modeLabel->setText(tr("follow") + ":");
     QWebElementCollection elements{currentFrame()->findAllElements("a, input")};
     elementMappings.clear();
 
-    int elementCount{0};
+    QList<QWebElement> visibleElements;
+    QVector<double> weights;
     for(auto it(elements.begin()) ; it != elements.end() ; it++) {
-        QRect elementRect{(*it).geometry()};
         if(isVisible(*it)) {
-            elementCount++;
+            visibleElements.append(*it);
+            weights.append(hintWeight(*it));
         }
     }
 
-    int mappingSize{int(std::ceil(std::log(elementCount) / std::log(26)))};
-    QString mapping{mappingSize, 'a'};
-
-    for(auto it(elements.begin()) ; it != elements.end() ; it++) {
-        if(isVisible(*it)) {
-            (*it).prependOutside(R"html(<span class=")html" + labelClass + R"html(" style=")html"
-                "background: white;"
-                "border: 1px solid black;"
-                "border-radius: 3px;"
-                "color: black;"
-                "font-family: sans-serif;"
-                "font-size: 12pt;"
-                "font-style: normal;"
-                "font-weight: bold;"
-                "padding: 0 2px 0 2px;"
-                "position: absolute;"
-                "text-transform: none;"
-                "z-index: 9999;"
-            "\">" + mapping + "</span>");
-            elementMappings[mapping] = *it;
-            nextMapping(mapping);
-        }
+    QStringList mappings{HintGenerator(hintAlphabet).labels(weights)};
+    for(int i{0} ; i < visibleElements.size() ; i++) {
+        QString const& mapping = mappings[i];
+        visibleElements[i].prependOutside(R"html(<span class=")html" + labelClass + R"html(" style=")html"
+            "background: white;"
+            "border: 1px solid black;"
+            "border-radius: 3px;"
+            "color: black;"
+            "font-family: sans-serif;"
+            "font-size: 12pt;"
+            "font-style: normal;"
+            "font-weight: bold;"
+            "padding: 0 2px 0 2px;"
+            "position: absolute;"
+            "text-transform: none;"
+            "z-index: 9999;"
+        "\">" + mapping + "</span>");
+        elementMappings[mapping] = visibleElements[i];
     }
 }
 
@@ -548,6 +1208,43 @@ void Window::showForwardSearchField() {
     showSearchField();
 }
 
+void Window::showImageStatistics() {
+    statusBar()->showMessage(page->imageReport(), 5000);
+}
+
+void Window::showIndexSearch() {
+    modeLabel->setText(tr("search history") + ":");
+    commandMode();
+    connect(lineEdit, &QLineEdit::returnPressed, this, &Window::indexSearch);
+}
+
+void Window::showNetworkStatistics() {
+    QString report{networkAccessManager->report()};
+    statusBar()->showMessage(report.isEmpty() ? tr("No requests") : report, 20000);
+}
+
+void Window::showNextPage() {
+    if(nullptr == prerenderer) {
+        return;
+    }
+
+    QUrl url{prerenderer->nextURL()};
+    if(url.isEmpty()) {
+        statusBar()->showMessage(tr("No next page"), 5000);
+        return;
+    }
+
+    WebPage* nextPage{prerenderer->take()};
+    if(nullptr == nextPage) {
+        loadURL(url);
+    }
+    else {
+        showWebView();
+        swapPage(nextPage);
+    }
+    statusBar()->showMessage(prerenderer->report(), 5000);
+}
+
 void Window::showOpen() {
     modeLabel->setText(tr("open") + ":");
     commandMode();
@@ -555,10 +1252,19 @@ void Window::showOpen() {
 }
 
 void Window::showOpenWithCurrentURL() {
-    lineEdit->setText(webView->url().toString());
+    lineEdit->setText(page->mainFrame()->url().toString());
     showOpen();
 }
 
+bool Window::showReader() {
+    QString html{ArticleExtractor::extract(page->mainFrame())};
+    if(html.isEmpty()) {
+        return false;
+    }
+    page->showReader(html);
+    return true;
+}
+
 void Window::showSearchField() {
     commandMode();
     connect(lineEdit, &QLineEdit::textEdited, this, &Window::incrementalSearch);
@@ -571,17 +1277,90 @@ void Window::showWindowOpen() {
     connect(lineEdit, &QLineEdit::returnPressed, this, &Window::windowOpen);
 }
 
+void Window::showWebView() {
+    if(textViewer->isVisible()) {
+        textViewer->closeFile();
+        textViewer->hide();
+        webView->show();
+        webView->setFocus();
+        titleChanged(page->mainFrame()->title());
+        urlLabel->setText(page->mainFrame()->url().toString());
+        updateScrollLabel();
+    }
+}
+
+void Window::swapPage(WebPage* newPage) {
+    disconnect(page, nullptr, this, nullptr);
+    disconnect(page->mainFrame(), nullptr, this, nullptr);
+    WebPage* oldPage{page};
+    page = newPage;
+    page->setVisibilityState(QWebPage::VisibilityStateVisible);
+    if(nullptr != tiledWebView) {
+        tiledWebView->setWebPage(page);
+    }
+    else {
+        modalWebView->setWebPage(page);
+    }
+    //The throttler of the previous page is deleted with it.
+    oldPage->deleteLater();
+    if(throttleEnabled) {
+        throttler = new Throttler(webView, page, throttleInterval);
+    }
+    connectPage();
+
+    //The page is already loaded.
+    titleChanged(page->mainFrame()->title());
+    urlChanged(page->mainFrame()->url());
+    iconChanged();
+    loadFinished();
+}
+
 void Window::titleChanged(QString const& title) {
     currentTitle = title;
     setTitle();
 }
 
+void Window::toggleReader() {
+    if(page->isReader()) {
+        readerSkipped = true;
+        page->mainFrame()->load(page->mainFrame()->url());
+    }
+    else if(not showReader()) {
+        statusBar()->showMessage(tr("No article found"), 5000);
+    }
+}
+
+void Window::tracePhase(QString const& phase) {
+    if(nullptr != options.startupTrace) {
+        options.startupTrace->mark(phase);
+    }
+}
+
+void Window::unsupportedContent(QNetworkReply* reply) {
+    QUrl url{reply->url()};
+    reply->abort();
+    reply->deleteLater();
+    downloadManager->download(url);
+}
+
 void Window::updateScrollLabel() {
-    if(0 == currentFrame()->scrollBarValue(Qt::Vertical) and 0 == currentFrame()->scrollBarMaximum(Qt::Vertical)) {
-            scrollValueLabel->setText("[" + tr("all") + "]");
+    //The first show resizes the window before the status bar is created.
+    if(nullptr == scrollValueLabel) {
+        return;
+    }
+
+    int scrollValue{scrollPosition().y()};
+    int maximum{scrollMaximum()};
+    if(textViewer->isVisible()) {
+        scrollValue = textViewer->verticalScrollBar()->value();
+        maximum = textViewer->verticalScrollBar()->maximum();
+    }
+
+    if(0 == scrollValue and 0 == maximum) {
+        scrollValueLabel->setText("[" + tr("all") + "]");
     }
     else {
-        int scrollPercentage = int(double(currentFrame()->scrollBarValue(Qt::Vertical)) / currentFrame()->scrollBarMaximum(Qt::Vertical) * 100);
+        int scrollPercentage = int(double(scrollValue) / maximum * 100);
         if(0 == scrollPercentage) {
             scrollValueLabel->setText("[" + tr("top") + "]");
         }
@@ -596,6 +1375,23 @@ void Window::updateScrollLabel() {
 
 void Window::urlChanged(QUrl const& url) {
     urlLabel->setText(url.toString());
+    if(nullptr != archive and not archive->contains(url)) {
+        closeArchive();
+    }
+}
+
+QSize Window::viewportSize() const {
+    if(isTiledScrolling()) {
+        return tiledWebView->viewport()->size();
+    }
+    return page->viewportSize();
+}
+
+QWidget* Window::webViewport() const {
+    if(nullptr != tiledWebView) {
+        return tiledWebView->viewport();
+    }
+    return webView;
 }
 
 void Window::windowOpen() {
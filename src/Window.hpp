@@ -19,22 +19,59 @@
 #define WINDOW_HPP
 
 #include <functional>
+#include <memory>
 
 #include <QDir>
 #include <QLabel>
 #include <QLineEdit>
 #include <QMainWindow>
 #include <QProgressBar>
+#include <QTimer>
 #include <QWebElement>
 
+#include "Archive.hpp"
+#include "BrowserContext.hpp"
+#include "CookieJar.hpp"
+#include "DownloadManager.hpp"
+#include "FrameTimer.hpp"
+#include "Frecency.hpp"
+#include "IdleScheduler.hpp"
+#include "KeyRecorder.hpp"
+#include "KeyReplayer.hpp"
 #include "ModalWebView.hpp"
+#include "NetworkAccessManager.hpp"
+#include "PageIndex.hpp"
+#include "Prerenderer.hpp"
+#include "ResourceMonitor.hpp"
+#include "Session.hpp"
+#include "SiteProfiles.hpp"
+#include "StartupTrace.hpp"
+#include "TextViewer.hpp"
+#include "Throttler.hpp"
+#include "TiledWebView.hpp"
+
+/*
+ * Options given on the command line.
+ */
+struct WindowOptions {
+    QString backend;
+    QString configPath = BrowserContext::defaultConfigPath();
+    bool frameStats = false;
+    bool placeholder = false;
+    QString recordFile;
+    QString replayFile;
+    bool restore = false;
+    QString sessionFile;
+    StartupTrace* startupTrace = nullptr;
+};
 
 /*
  * Main window of the web browser.
  */
 class Window : public QMainWindow {
     public:
-        Window(QString const& initialURL);
+        Window(QString const& initialURL, WindowOptions const& initialOptions);
+        ~Window();
 
         Window(Window const&) = delete;
 
@@ -56,6 +93,8 @@ class Window : public QMainWindow {
         void openNewWindow(QUrl const& url);
 
     protected:
+        virtual void changeEvent(QEvent* event);
+
         virtual void keyPressEvent(QKeyEvent* keyEvent);
 
         virtual void resizeEvent(QResizeEvent* windowResizeEvent);
@@ -67,32 +106,75 @@ class Window : public QMainWindow {
             SAME_WINDOW
         };
 
-        QString const CONFIG_PATH = QDir::homePath() + "/.navim";
+        QString const CONFIG_PATH;
+        double const FRECENCY_WEIGHT = 4;
         QString const labelClass = "__navim_label__";
+        int const MAX_INDEX_RESULTS = 50;
         int const SCROLL_DELTA = 50;
 
+        std::unique_ptr<Archive> archive;
+        BrowserContext browserContext;
         QString command;
         QMap<QChar, std::function<void(Window*)>> controlKeybindings;
+        int cookieInterval = 10000;
+        QTimer cookieTimer;
         QString currentTitle;
+        int downloadConnections = 4;
+        qint64 downloadRateLimit = 0;
         QMap<QString, QWebElement> elementMappings;
+        QMap<QString, std::function<void(Window*, QStringList const&)>> exCommands;
         int fieldIndex = 0;
         QWebPage::FindFlags findFlags = QWebPage::FindWrapsAroundDocument | QWebPage::HighlightAllOccurrences;
         FollowMode followMode = FollowMode::NORMAL;
+        FrameTimer frameTimer;
+        Frecency frecency;
+        QString hintAlphabet = "auiectsrn";
         QUrl homepage;
+        IdleScheduler idleScheduler;
         bool inProgress = false;
         QMap<QString, std::function<void(Window*)>> keybindings;
+        bool leavingSession = false;
         Mode mode = Mode::NORMAL;
+        int monitorCpuThreshold = 90;
+        bool monitorEnabled = false;
+        qint64 monitorMemoryThreshold = 1024;
+        WindowOptions options;
+        PageIndex pageIndex;
+        qint64 prerenderBudget = 512;
+        bool prerenderEnabled = true;
         int progression = 0;
+        bool readerSkipped = false;
+        bool restoringSession = false;
         QString searchText = "";
+        Session session;
+        int sessionInterval = 60000;
+        SessionState sessionState;
+        QTimer sessionTimer;
+        SiteProfiles siteProfiles;
         int statusBarFontSize = 0;
+        qint64 textViewerThreshold = 16 * 1024 * 1024;
+        bool throttleEnabled = true;
+        int throttleInterval = 1000;
 
         QLabel* commandLabel = nullptr;
+        DownloadManager* downloadManager = nullptr;
+        QProgressBar* downloadProgressBar = nullptr;
+        KeyRecorder* keyRecorder = nullptr;
+        KeyReplayer* keyReplayer = nullptr;
         QLineEdit* lineEdit = nullptr;
+        ModalWebView* modalWebView = nullptr;
         QLabel* modeLabel = nullptr;
+        NetworkAccessManager* networkAccessManager = nullptr;
+        WebPage* page = nullptr;
+        Prerenderer* prerenderer = nullptr;
         QProgressBar* progressBar = nullptr;
+        ResourceMonitor* resourceMonitor = nullptr;
         QLabel* scrollValueLabel = nullptr;
+        TextViewer* textViewer = nullptr;
+        Throttler* throttler = nullptr;
+        TiledWebView* tiledWebView = nullptr;
         QLabel* urlLabel = nullptr;
-        ModalWebView* webView = nullptr;
+        QWidget* webView = nullptr;
 
         /*
          * Clear the last search.
@@ -104,16 +186,31 @@ class Window : public QMainWindow {
          */
         void click(QWebElement const& element);
 
+        /*
+         * Stop serving the resources from the opened archive.
+         */
+        void closeArchive();
+
+        /*
+         * Close the window and remove it from the session.
+         */
+        void closeWindow();
+
         /*
          * Change to command mode.
          */
         void commandMode();
 
         /*
-         * Configure the main window.
+         * Create the configuration directory and load the data stored in it.
          */
         void configure();
 
+        /*
+         * Connect the events of the page.
+         */
+        void connectPage();
+
         /*
          * Create the widgets events.
          */
@@ -125,7 +222,17 @@ class Window : public QMainWindow {
         void createShortcuts();
 
         /*
-         * Create the widgets.
+         * Create a page with the settings of the window.
+         */
+        WebPage* createPage();
+
+        /*
+         * Create the web view and the text viewer, needed to show the first page.
+         */
+        void createWebView();
+
+        /*
+         * Create the status bar and the other widgets not needed to show the first page.
          */
         void createWidgets();
 
@@ -134,6 +241,21 @@ class Window : public QMainWindow {
          */
         QWebFrame* currentFrame() const;
 
+        /*
+         * Download progress event.
+         */
+        void downloadProgress(qint64 received, qint64 total, QStringList const& names);
+
+        /*
+         * Get the key identifying the element in the frecency table.
+         */
+        QString elementKey(QWebElement const& element) const;
+
+        /*
+         * Execute the command typed after ':'.
+         */
+        void exCommand();
+
         /*
          * Find the next occurence of the search string.
          */
@@ -149,6 +271,11 @@ class Window : public QMainWindow {
          */
         void focusNextField();
 
+        /*
+         * Get how likely the element is to be followed.
+         */
+        double hintWeight(QWebElement const& element);
+
         /*
          * Go back in history.
          */
@@ -169,16 +296,32 @@ class Window : public QMainWindow {
          */
         void incrementalSearch(QString const& text);
 
+        /*
+         * Search the page index with the query in the input text field.
+         */
+        void indexSearch();
+
         /*
          * Change to insert mode.
          */
         void insertMode();
 
+        /*
+         * Create what is not needed to show the first page, load it if it was not loaded yet and start the other
+         * windows of the restored session.
+         */
+        void initializeDeferred(QUrl const& firstURL, QStringList const& otherSessions);
+
         /*
          * Check if the current mode is FOLLOW or FOLLOW_SAME.
          */
         bool isFollow() const;
 
+        /*
+         * Check if the scrolling goes through the tiled view (the main frame is resized to its contents).
+         */
+        bool isTiledScrolling() const;
+
         /*
          * Check if an element is currently visible.
          */
@@ -199,11 +342,6 @@ class Window : public QMainWindow {
          */
         void loadFinished();
 
-        /*
-         * Load the URL from the command line argument or the homepage if no URL was provided.
-         */
-        void loadInitialURLOrHomepage(QString const& initialURL);
-
         /*
          * Load progress event.
          */
@@ -215,15 +353,26 @@ class Window : public QMainWindow {
         void loadStarted();
 
         /*
-         * Generate a mapping from the previous mapping.
+         * Load the URL in the web view or in the text viewer if it is a huge local text file.
          */
-        void nextMapping(QString& mapping);
+        void loadURL(QUrl const& url);
 
         /*
          * Open the URL in the input text field.
          */
         void open();
 
+        /*
+         * Open the archive if the url is a local archive file.
+         * Return true if the archive was opened.
+         */
+        bool openArchive(QUrl const& url);
+
+        /*
+         * Open the URL in the text viewer if it is a local text file bigger than the threshold.
+         */
+        bool openInTextViewer(QUrl const& url);
+
         /*
          * Reload the page.
          */
@@ -249,6 +398,36 @@ class Window : public QMainWindow {
          */
         void removeLabels();
 
+        /*
+         * Remove the cache directories of the window processes not running anymore.
+         */
+        void removeStaleCaches();
+
+        /*
+         * Load the history of the restored session.
+         */
+        void restoreSession();
+
+        /*
+         * Save the current page and its cached resources in an archive named by the first argument.
+         */
+        void saveArchive(QStringList const& arguments);
+
+        /*
+         * Save the state of the window in its session file.
+         */
+        void saveSession();
+
+        /*
+         * Script interrupted event.
+         */
+        void scriptInterrupted(QString const& host, qint64 time);
+
+        /*
+         * Scroll the current frame by the offset.
+         */
+        void scrollBy(int dx, int dy);
+
         /*
          * Scroll down the web view.
          */
@@ -274,6 +453,16 @@ class Window : public QMainWindow {
          */
         void scrollRight();
 
+        /*
+         * Get the maximum vertical scroll position of the current frame.
+         */
+        int scrollMaximum() const;
+
+        /*
+         * Get the scroll position of the current frame.
+         */
+        QPoint scrollPosition() const;
+
         /*
          * Scroll to the end of the page.
          */
@@ -304,6 +493,11 @@ class Window : public QMainWindow {
          */
         void search();
 
+        /*
+         * Set the scroll position of the current frame.
+         */
+        void setScrollPosition(QPoint const& position);
+
         /*
          * Set the window title with the progress in a web page is loading.
          */
@@ -314,6 +508,11 @@ class Window : public QMainWindow {
          */
         void showBackwardSearchField();
 
+        /*
+         * Show the command line.
+         */
+        void showExCommand();
+
         /*
          * Show the labels on links and form elements.
          */
@@ -334,6 +533,26 @@ class Window : public QMainWindow {
          */
         void showForwardSearchField();
 
+        /*
+         * Show the images downscaled for the current page and the memory saved.
+         */
+        void showImageStatistics();
+
+        /*
+         * Show the page index search field.
+         */
+        void showIndexSearch();
+
+        /*
+         * Show the connection statistics of the hosts.
+         */
+        void showNetworkStatistics();
+
+        /*
+         * Show the next page of the document, prerendered if possible.
+         */
+        void showNextPage();
+
         /*
          * Show open URL input text field.
          */
@@ -344,21 +563,52 @@ class Window : public QMainWindow {
          */
         void showOpenWithCurrentURL();
 
+        /*
+         * Show the reader view of the page.
+         * Return false if no article is found.
+         */
+        bool showReader();
+
         /*
          * Show the search field.
          */
         void showSearchField();
 
+        /*
+         * Show the web view instead of the text viewer.
+         */
+        void showWebView();
+
         /*
          * Show open in a new window URL input text field.
          */
         void showWindowOpen();
 
+        /*
+         * Replace the current page by a loaded page.
+         */
+        void swapPage(WebPage* newPage);
+
+        /*
+         * Show the reader view of the page or go back to the original page.
+         */
+        void toggleReader();
+
         /*
          * Title changed event.
          */
         void titleChanged(QString const& title);
 
+        /*
+         * Record the end of a startup phase when the startup is traced.
+         */
+        void tracePhase(QString const& phase);
+
+        /*
+         * Unsupported content event: download it.
+         */
+        void unsupportedContent(QNetworkReply* reply);
+
         /*
          * Update the scroll label.
          */
@@ -369,6 +619,16 @@ class Window : public QMainWindow {
          */
         void urlChanged(QUrl const& url);
 
+        /*
+         * Get the size of the visible part of the current frame.
+         */
+        QSize viewportSize() const;
+
+        /*
+         * Get the widget receiving the mouse events of the web view.
+         */
+        QWidget* webViewport() const;
+
         /*
          * Open the URL from the input text field in a new window.
          */
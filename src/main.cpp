@@ -15,17 +15,127 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <cstring>
+#include <memory>
+
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
 
+#include "HeadlessRenderer.hpp"
 #include "Window.hpp"
 
+/*
+ * Read the URLs from the arguments: an argument naming an existing file is a list of URLs, one per line.
+ */
+static QStringList readURLs(QStringList const& arguments) {
+    QStringList urls;
+    for(QString const& argument : arguments) {
+        QFile file{argument};
+        if(file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            QTextStream stream{&file};
+            while(not stream.atEnd()) {
+                QString line{stream.readLine().trimmed()};
+                if(not line.isEmpty() and not line.startsWith('#')) {
+                    urls << line;
+                }
+            }
+        }
+        else {
+            urls << argument;
+        }
+    }
+    return urls;
+}
+
 int main(int argc, char* argv[]) {
+    StartupTrace startupTrace;
+
+    //The platform must be chosen before the application is created.
+    for(int i{1} ; i < argc ; i++) {
+        if((0 == std::strcmp(argv[i], "--headless") or 0 == std::strcmp(argv[i], "--replay")) and not qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
     QApplication app(argc, argv);
+    startupTrace.mark("application");
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    parser.addPositionalArgument("url", "URL to open (with --headless, URLs or files listing one URL per line).", "[url...]");
+    QCommandLineOption headlessOption{"headless", "Render the URLs without window."};
+    QCommandLineOption jobsOption{"jobs", "Number of pages rendering in parallel.", "count", "4"};
+    QCommandLineOption outputOption{"output", "Directory where the renderings are written.", "directory", "."};
+    QCommandLineOption formatOption{"format", "Rendering format: png, text or html.", "format", "png"};
+    QCommandLineOption timeoutOption{"timeout", "Maximum time to load a page in milliseconds.", "ms", "30000"};
+    QCommandLineOption backendOption{"backend", "Rendering backend: widget or tiled (overrides view/backend).", "backend"};
+    QCommandLineOption frameStatsOption{"frame-stats", "Print the paint time and the input latency statistics of the web view on exit."};
+    QCommandLineOption startupTraceOption{"startup-trace", "Print the time taken by every startup phase until the first page is painted."};
+    QCommandLineOption restoreOption{"restore", "Restore the windows of the last session."};
+    QCommandLineOption sessionOption{"session", "Restore the window saved in the session file.", "file"};
+    QCommandLineOption placeholderOption{"placeholder", "With --session, load the page when the window is first focused."};
+    QCommandLineOption recordOption{"record", "Record the keys pressed in the window to the file, and the frecency scores to file.frecency.", "file"};
+    QCommandLineOption replayOption{"replay", "Replay the keys recorded in the file once the page is loaded, with a copy of the configuration, print the latency of every key and quit.", "file"};
+    parser.addOptions({headlessOption, jobsOption, outputOption, formatOption, timeoutOption, backendOption, frameStatsOption, startupTraceOption, restoreOption, sessionOption, placeholderOption, recordOption, replayOption});
+    parser.process(app);
+
+    if(parser.isSet(headlessOption)) {
+        QStringList urls{readURLs(parser.positionalArguments())};
+        if(urls.isEmpty()) {
+            parser.showHelp(1);
+        }
+
+        QString formatName{parser.value(formatOption)};
+        HeadlessRenderer::Format format{HeadlessRenderer::Format::PNG};
+        if("html" == formatName) {
+            format = HeadlessRenderer::Format::HTML;
+        }
+        else if("text" == formatName) {
+            format = HeadlessRenderer::Format::TEXT;
+        }
+
+        HeadlessRenderer renderer(urls, parser.value(outputOption), format, parser.value(jobsOption).toInt(), parser.value(timeoutOption).toInt());
+        renderer.start();
+        return app.exec();
+    }
+
     QString initialURL;
-    if(argc >= 2) {
-        initialURL = argv[1];
+    if(not parser.positionalArguments().isEmpty()) {
+        initialURL = parser.positionalArguments().first();
     }
-    Window window(initialURL);
+    WindowOptions options;
+    options.backend = parser.value(backendOption);
+    options.frameStats = parser.isSet(frameStatsOption);
+    options.placeholder = parser.isSet(placeholderOption);
+    options.recordFile = parser.value(recordOption);
+    options.replayFile = parser.value(replayOption);
+    options.restore = parser.isSet(restoreOption);
+    options.sessionFile = parser.value(sessionOption);
+    if(parser.isSet(startupTraceOption)) {
+        startupTrace.mark("command line");
+        options.startupTrace = &startupTrace;
+    }
+
+    //The hints depend on the frecency: the replay starts from the scores the recording started with.
+    if(not options.recordFile.isEmpty()) {
+        QFile::remove(options.recordFile + ".frecency");
+        QFile::copy(options.configPath + "/frecency", options.recordFile + ".frecency");
+    }
+    //A replay runs with a copy of the settings and of the cookies, and does not change the configuration of the user.
+    std::unique_ptr<QTemporaryDir> replayDirectory;
+    if(not options.replayFile.isEmpty()) {
+        replayDirectory.reset(new QTemporaryDir);
+        for(QString const& name : QStringList{"config.ini", "cookies", "profiles.ini"}) {
+            QFile::copy(options.configPath + "/" + name, replayDirectory->filePath(name));
+        }
+        QFile::copy(options.replayFile + ".frecency", replayDirectory->filePath("frecency"));
+        options.configPath = replayDirectory->path();
+    }
+
+    Window window(initialURL, options);
     window.show();
     return app.exec();
 }
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2015  Boucher, Antoni <bouanto@gmail.com>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <limits>
+
+#include <QNetworkAccessManager>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QtTest>
+
+#include "Download.hpp"
+
+/*
+ * Local HTTP server sending a file, with or without honoring the ranges.
+ */
+class FileServer : public QTcpServer {
+    public:
+        FileServer(QByteArray const& initialContent, bool initialRangesHonored) : QTcpServer(), content(initialContent), rangesHonored(initialRangesHonored) {
+            connect(this, &QTcpServer::newConnection, this, [this]() {
+                while(hasPendingConnections()) {
+                    QTcpSocket* socket{nextPendingConnection()};
+                    connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                        serve(socket);
+                    });
+                    connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+                }
+            });
+        }
+
+        /*
+         * Number of requests with a range.
+         */
+        int rangeRequests = 0;
+
+    private:
+        QByteArray content;
+        bool rangesHonored;
+
+        /*
+         * Answer the complete requests received on the socket.
+         */
+        void serve(QTcpSocket* socket) {
+            QByteArray buffer{socket->property("buffer").toByteArray() + socket->readAll()};
+            int end{buffer.indexOf("\r\n\r\n")};
+            while(-1 != end) {
+                QList<QByteArray> lines{buffer.left(end).split('\n')};
+                buffer.remove(0, end + 4);
+                bool head{lines[0].startsWith("HEAD ")};
+
+                qint64 first{0};
+                qint64 last{content.size() - 1};
+                bool ranged{false};
+                for(QByteArray const& line : lines) {
+                    if(line.toLower().startsWith("range: bytes=")) {
+                        QList<QByteArray> bounds{line.trimmed().mid(13).split('-')};
+                        rangeRequests++;
+                        if(rangesHonored) {
+                            ranged = true;
+                            first = bounds[0].toLongLong();
+                            if(not bounds[1].isEmpty()) {
+                                last = bounds[1].toLongLong();
+                            }
+                        }
+                    }
+                }
+
+                QByteArray response{ranged ? "HTTP/1.1 206 Partial Content\r\n" : "HTTP/1.1 200 OK\r\n"};
+                //The server advertises the ranges even when it ignores them.
+                response += "Accept-Ranges: bytes\r\n";
+                response += "Content-Length: " + QByteArray::number(last - first + 1) + "\r\n";
+                if(ranged) {
+                    response += "Content-Range: bytes " + QByteArray::number(first) + "-" + QByteArray::number(last) + "/" + QByteArray::number(content.size()) + "\r\n";
+                }
+                response += "\r\n";
+                if(not head) {
+                    response += content.mid(int(first), int(last - first + 1));
+                }
+                socket->write(response);
+                end = buffer.indexOf("\r\n\r\n");
+            }
+            socket->setProperty("buffer", buffer);
+        }
+};
+
+class DownloadTest : public QObject {
+    Q_OBJECT
+
+    private slots:
+        void ignoredRanges();
+        void ranges();
+
+    private:
+        /*
+         * Download the content from a server and check the downloaded file.
+         */
+        void checkDownload(FileServer& server, QByteArray const& content);
+
+        /*
+         * Content large enough to be split in several segments.
+         */
+        static QByteArray fileContent();
+};
+
+void DownloadTest::checkDownload(FileServer& server, QByteArray const& content) {
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QTemporaryDir directory;
+    QString path{directory.filePath("file")};
+    QNetworkAccessManager networkAccessManager;
+    Download download{QUrl("http://127.0.0.1:" + QString::number(server.serverPort()) + "/file"), path, &networkAccessManager};
+    download.readyRead = [&download]() {
+        download.transfer(std::numeric_limits<qint64>::max());
+    };
+    download.start(4);
+    QTRY_VERIFY_WITH_TIMEOUT(download.isFinished(), 10000);
+    QCOMPARE(download.received(), qint64(content.size()));
+
+    QFile file{path};
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(file.readAll() == content);
+}
+
+QByteArray DownloadTest::fileContent() {
+    QByteArray content;
+    for(int i{0} ; i < 3 * 1024 * 1024 ; i++) {
+        content += char(i * 7 % 251);
+    }
+    return content;
+}
+
+void DownloadTest::ignoredRanges() {
+    //A 200 reply to a range request holds the whole file: it must not overrun the segment.
+    QByteArray content{fileContent()};
+    FileServer server{content, false};
+    checkDownload(server, content);
+    QVERIFY(server.rangeRequests > 0);
+}
+
+void DownloadTest::ranges() {
+    QByteArray content{fileContent()};
+    FileServer server{content, true};
+    checkDownload(server, content);
+    QVERIFY(server.rangeRequests > 1);
+}
+
+QTEST_GUILESS_MAIN(DownloadTest)
+#include "DownloadTest.moc"
@@ -0,0 +1,13 @@
+CONFIG += c++14 debug silent testcase
+DESTDIR = build
+INCLUDEPATH += ../src
+MOC_DIR = build
+OBJECTS_DIR = build
+QT += network testlib
+QT -= gui
+TARGET = DownloadTest
+TEMPLATE = app
+
+# Input
+HEADERS += ../src/Download.hpp
+SOURCES += DownloadTest.cpp ../src/Download.cpp